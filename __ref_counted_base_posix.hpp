@@ -6,29 +6,65 @@
 #include <pthread.h>
 
 #include <cassert>
+#include <climits>
+#include <cstddef>
+
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+#include <new>
+#endif
 
 // #include <iostream>
 // #define OUTPUT_REF_COUNTED std::cout
 
+// define SMART_PTR_ITERATIVE_RELEASE to dispose objects from a per thread worklist
+// instead of recursively, so long chains of shared_ptr can not overflow the stack.
+// it adds a member to _counted_base: every translation unit of a program must agree on it,
+// define it on the command line rather than before an include.
+
 namespace ft
 {
     namespace _internal
     {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        struct release_worklist;
+#endif
+
         class _counted_base
         {
         private:
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+            friend struct release_worklist;
+#endif
+
             typedef signed int count_type;
 
             count_type shared_count;
             count_type weak_count;
             mutable pthread_mutex_t mutex;
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+            _counted_base* next_release; // worklist link, once the shared count is zero
+#endif
 
             _counted_base(const _counted_base&);
             _counted_base& operator=(const _counted_base&);
 
+            // counts are only written under the mutex, unique() reads shared_count without it
+            static void store_count(count_type& count, count_type value) throw()
+            {
+#ifdef __GNUC__
+                __atomic_store_n(&count, value, __ATOMIC_RELEASE);
+#else
+                count = value;
+#endif
+            }
+
         public:
             _counted_base()
                 : shared_count(1), weak_count(1)
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+                  ,
+                  next_release(NULL)
+#endif
             {
                 assert(pthread_mutex_init(&this->mutex, 0) == 0);
             }
@@ -41,13 +77,15 @@ namespace ft
             virtual void dispose() = 0; // throw()
             virtual void destroy() = 0; // throw()
 
-            void add_ref_copy()
+            // `n` references in one step
+            void add_ref_copy(std::size_t n = 1)
             {
                 assert(pthread_mutex_lock(&this->mutex) == 0);
 #ifdef OUTPUT_REF_COUNTED
-                OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": ++" << this->shared_count << " (Weak=" << this->weak_count << ")" << std::endl;
+                OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": +" << n << " " << this->shared_count << " (Weak=" << this->weak_count << ")" << std::endl;
 #endif
-                ++this->shared_count;
+                assert(n <= static_cast<std::size_t>(INT_MAX - this->shared_count) && "reference count overflow");
+                store_count(this->shared_count, this->shared_count + static_cast<count_type>(n));
                 assert(pthread_mutex_unlock(&this->mutex) == 0);
             }
 
@@ -57,24 +95,31 @@ namespace ft
 #ifdef OUTPUT_REF_COUNTED
                 OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": ++" << this->shared_count << " (Weak=" << this->weak_count << ")" << std::endl;
 #endif
-                bool success = this->shared_count == 0 ? false : (static_cast<void>(++this->shared_count), true);
+                bool success = this->shared_count == 0 ? false : (store_count(this->shared_count, this->shared_count + 1), true);
                 assert(pthread_mutex_unlock(&this->mutex) == 0);
                 return success;
             }
 
-            void release() // throw()
+            // drops `n` references in one step
+            void release(std::size_t n = 1) // throw()
             {
                 assert(pthread_mutex_lock(&this->mutex) == 0);
 #ifdef OUTPUT_REF_COUNTED
-                OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": --" << this->shared_count << " (Weak=" << this->weak_count << ")" << std::endl;
+                OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": -" << n << " " << this->shared_count << " (Weak=" << this->weak_count << ")" << std::endl;
 #endif
-                bool release_resource = --this->shared_count == 0;
+                assert(n <= static_cast<std::size_t>(this->shared_count));
+                store_count(this->shared_count, this->shared_count - static_cast<count_type>(n));
+                bool release_resource = this->shared_count == 0;
                 assert(pthread_mutex_unlock(&this->mutex) == 0);
 
                 if (release_resource)
                 {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+                    this->schedule_dispose();
+#else
                     this->dispose();
                     this->weak_release();
+#endif
                 }
             }
 
@@ -84,7 +129,7 @@ namespace ft
 #ifdef OUTPUT_REF_COUNTED
                 OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": " << this->shared_count << " (Weak=++" << this->weak_count << ")" << std::endl;
 #endif
-                ++this->weak_count;
+                store_count(this->weak_count, this->weak_count + 1);
                 assert(pthread_mutex_unlock(&this->mutex) == 0);
             }
 
@@ -94,7 +139,8 @@ namespace ft
 #ifdef OUTPUT_REF_COUNTED
                 OUTPUT_REF_COUNTED << static_cast<const void*>(this) << ": " << __PRETTY_FUNCTION__ << ": " << this->shared_count << " (Weak=--" << this->weak_count << ")" << std::endl;
 #endif
-                bool release_this = --this->weak_count == 0;
+                store_count(this->weak_count, this->weak_count - 1);
+                bool release_this = this->weak_count == 0;
                 assert(pthread_mutex_unlock(&this->mutex) == 0);
 
                 if (release_this)
@@ -103,6 +149,13 @@ namespace ft
                 }
             }
 
+            // only valid once both counts dropped to zero and nothing refers to this block anymore
+            void revive() throw()
+            {
+                this->shared_count = 1;
+                this->weak_count = 1;
+            }
+
             long use_count() const // throw()
             {
                 assert(pthread_mutex_lock(&this->mutex) == 0);
@@ -114,6 +167,135 @@ namespace ft
 
                 return value;
             }
+
+            bool unique() const // throw()
+            {
+#ifdef __GNUC__
+                // a single acquire load, pairs with the release store of the last other owner
+                return __atomic_load_n(&this->shared_count, __ATOMIC_ACQUIRE) == 1;
+#else
+                return this->use_count() == 1;
+#endif
+            }
+
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        private:
+            inline void schedule_dispose() throw();
+#endif
+        };
+
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        // blocks of this thread whose shared count dropped to zero and await dispose().
+        // the outermost release drains it, releases made by the destructors it runs only push.
+        struct release_worklist
+        {
+            static const std::size_t unlimited = static_cast<std::size_t>(-1);
+
+            _counted_base* head;
+            std::size_t pending;
+            std::size_t budget; // blocks disposed per outermost release
+            bool draining;
+
+        public:
+            release_worklist() throw()
+                : head(NULL), pending(0), budget(unlimited), draining(false) {}
+
+            void push(_counted_base* counted) throw()
+            {
+                counted->next_release = this->head;
+                this->head = counted;
+                ++this->pending;
+            }
+
+            // disposes up to `limit` blocks, returns the number left
+            std::size_t drain(std::size_t limit) throw()
+            {
+                if (this->draining)
+                {
+                    return this->pending;
+                }
+
+                this->draining = true;
+                for (; this->head != NULL && limit != 0; --limit)
+                {
+                    _counted_base* counted = this->head;
+                    this->head = counted->next_release;
+                    --this->pending;
+
+                    counted->next_release = NULL;
+                    counted->dispose();
+                    counted->weak_release();
+                }
+                this->draining = false;
+                return this->pending;
+            }
+
+            // NULL if it can not be allocated
+            static release_worklist* current() throw()
+            {
+                static pthread_once_t once = PTHREAD_ONCE_INIT;
+                pthread_once(&once, &release_worklist::create_key);
+                if (!key_created())
+                {
+                    return NULL;
+                }
+
+                release_worklist* list = static_cast<release_worklist*>(pthread_getspecific(key()));
+                if (list == NULL)
+                {
+                    list = ::new (std::nothrow) release_worklist();
+                    if (list != NULL && pthread_setspecific(key(), list) != 0)
+                    {
+                        ::delete list;
+                        list = NULL;
+                    }
+                }
+                return list;
+            }
+
+        private:
+            static pthread_key_t& key() throw()
+            {
+                static pthread_key_t value;
+                return value;
+            }
+
+            static bool& key_created() throw()
+            {
+                static bool value = false;
+                return value;
+            }
+
+            // without a key every release disposes recursively
+            static void create_key() throw()
+            {
+                key_created() = pthread_key_create(&key(), &release_worklist::thread_exit) == 0;
+            }
+
+            // blocks left over by a budget are disposed when the thread exits
+            static void thread_exit(void* p) throw()
+            {
+                release_worklist* list = static_cast<release_worklist*>(p);
+                pthread_setspecific(key(), list);
+                list->drain(unlimited);
+                pthread_setspecific(key(), NULL);
+                ::delete list;
+            }
         };
+
+        inline void _counted_base::schedule_dispose() throw()
+        {
+            release_worklist* list = release_worklist::current();
+            if (list == NULL)
+            {
+                this->dispose();
+                this->weak_release();
+                return;
+            }
+
+            list->push(this);
+            list->drain(list->budget);
+        }
+#endif
     }
 }
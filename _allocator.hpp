@@ -0,0 +1,34 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_ptr_element.hpp"
+
+#include <memory>
+
+namespace ft
+{
+    namespace _internal
+    {
+        // TAlloc for U. std::allocator::rebind is gone in C++20 and minimal allocators,
+        // std::pmr::polymorphic_allocator among them, never had it.
+        template <typename TAlloc, typename U>
+        struct rebind_alloc
+        {
+#if __cplusplus >= 201103L
+            typedef typename std::allocator_traits<TAlloc>::template rebind_alloc<U> type;
+#else
+            typedef typename TAlloc::template rebind<U>::other type;
+#endif
+        };
+
+        // allocator of make_shared, always rebound before use.
+        // std::allocator of an array type is ill-formed, its element is used instead.
+        template <typename T>
+        struct default_allocator
+        {
+            typedef std::allocator<typename scalar_type<typename element_type<T>::type>::type> type;
+        };
+    }
+}
@@ -0,0 +1,129 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_ptr_element.hpp"
+
+namespace ft
+{
+    namespace _internal
+    {
+        // leaves the first member default initialized, raw storage is not zeroed nor copied
+        struct default_first_tag
+        {
+        };
+
+        // 0: no empty member, 1: first is empty, 2: second is empty, 3: both are empty
+        template <typename T1, typename T2>
+        struct compressed_pair_kind
+        {
+            static const int value = (is_empty<T1>::value ? 1 : 0) + (is_empty<T2>::value && !is_same<T1, T2>::value ? 2 : 0);
+        };
+
+        template <typename T1, typename T2, int Kind = compressed_pair_kind<T1, T2>::value>
+        class compressed_pair;
+
+        template <typename T1, typename T2>
+        class compressed_pair<T1, T2, 0>
+        {
+        private:
+            T1 v1;
+            T2 v2;
+
+        public:
+            compressed_pair()
+                : v1(), v2() {}
+
+            explicit compressed_pair(const T1& v1)
+                : v1(v1), v2() {}
+
+            compressed_pair(const T1& v1, const T2& v2)
+                : v1(v1), v2(v2) {}
+
+            compressed_pair(default_first_tag, const T2& v2)
+                : v2(v2) {}
+
+            T1& first() throw() { return this->v1; }
+            const T1& first() const throw() { return this->v1; }
+
+            T2& second() throw() { return this->v2; }
+            const T2& second() const throw() { return this->v2; }
+        };
+
+        template <typename T1, typename T2>
+        class compressed_pair<T1, T2, 1> : private T1
+        {
+        private:
+            T2 v2;
+
+        public:
+            compressed_pair()
+                : T1(), v2() {}
+
+            explicit compressed_pair(const T1& v1)
+                : T1(v1), v2() {}
+
+            compressed_pair(const T1& v1, const T2& v2)
+                : T1(v1), v2(v2) {}
+
+            compressed_pair(default_first_tag, const T2& v2)
+                : T1(), v2(v2) {}
+
+            T1& first() throw() { return *this; }
+            const T1& first() const throw() { return *this; }
+
+            T2& second() throw() { return this->v2; }
+            const T2& second() const throw() { return this->v2; }
+        };
+
+        template <typename T1, typename T2>
+        class compressed_pair<T1, T2, 2> : private T2
+        {
+        private:
+            T1 v1;
+
+        public:
+            compressed_pair()
+                : T2(), v1() {}
+
+            explicit compressed_pair(const T1& v1)
+                : T2(), v1(v1) {}
+
+            compressed_pair(const T1& v1, const T2& v2)
+                : T2(v2), v1(v1) {}
+
+            compressed_pair(default_first_tag, const T2& v2)
+                : T2(v2) {}
+
+            T1& first() throw() { return this->v1; }
+            const T1& first() const throw() { return this->v1; }
+
+            T2& second() throw() { return *this; }
+            const T2& second() const throw() { return *this; }
+        };
+
+        template <typename T1, typename T2>
+        class compressed_pair<T1, T2, 3> : private T1, private T2
+        {
+        public:
+            compressed_pair()
+                : T1(), T2() {}
+
+            explicit compressed_pair(const T1& v1)
+                : T1(v1), T2() {}
+
+            compressed_pair(const T1& v1, const T2& v2)
+                : T1(v1), T2(v2) {}
+
+            compressed_pair(default_first_tag, const T2& v2)
+                : T1(), T2(v2) {}
+
+            T1& first() throw() { return *this; }
+            const T1& first() const throw() { return *this; }
+
+            T2& second() throw() { return *this; }
+            const T2& second() const throw() { return *this; }
+        };
+    }
+}
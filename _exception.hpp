@@ -0,0 +1,24 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include <cstdlib>
+
+// define SMART_PTR_NO_EXCEPTIONS, or build with -fno-exceptions, to compile out every try/catch.
+// errors that would throw call std::abort() instead.
+#if !defined(SMART_PTR_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define SMART_PTR_NO_EXCEPTIONS
+#endif
+
+#ifdef SMART_PTR_NO_EXCEPTIONS
+#define SMART_PTR_TRY if (true)
+#define SMART_PTR_CATCH_ALL else
+#define SMART_PTR_RETHROW std::abort()
+#define SMART_PTR_THROW(e) std::abort()
+#else
+#define SMART_PTR_TRY try
+#define SMART_PTR_CATCH_ALL catch (...)
+#define SMART_PTR_RETHROW throw
+#define SMART_PTR_THROW(e) throw e
+#endif
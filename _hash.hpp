@@ -0,0 +1,144 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace ft
+{
+    namespace _internal
+    {
+        // murmur3 finalizer of the width of `TSize`
+        template <typename TSize, std::size_t Bytes = sizeof(TSize)>
+        struct fmix
+        {
+            static TSize apply(TSize h) throw()
+            {
+                h ^= h >> 16;
+                h *= static_cast<TSize>(0x85ebca6bUL);
+                h ^= h >> 13;
+                h *= static_cast<TSize>(0xc2b2ae35UL);
+                h ^= h >> 16;
+                return h;
+            }
+        };
+
+        template <typename TSize>
+        struct fmix<TSize, 8>
+        {
+            static TSize apply(TSize h) throw()
+            {
+                h ^= h >> 33;
+                h *= static_cast<TSize>(0xff51afd7UL) << 32 | static_cast<TSize>(0xed558ccdUL);
+                h ^= h >> 33;
+                h *= static_cast<TSize>(0xc4ceb9feUL) << 32 | static_cast<TSize>(0x1a85ec53UL);
+                h ^= h >> 33;
+                return h;
+            }
+        };
+
+        // spreads every bit of `h` over the low bits, which bucket and shard indexes use.
+        // pointers and identity hashes of integers have their low bits all equal otherwise.
+        inline std::size_t mix_hash(std::size_t h) throw()
+        {
+            return fmix<std::size_t>::apply(h);
+        }
+
+#if __cplusplus >= 201103L
+        template <typename T>
+        struct hash : std::hash<T>
+        {
+        };
+#else
+        // only the types below have a hash, pass a hasher for any other key type
+        template <typename T>
+        struct hash;
+
+        template <typename T>
+        struct integral_hash
+        {
+            std::size_t operator()(T value) const throw() { return static_cast<std::size_t>(value); }
+        };
+
+        template <>
+        struct hash<bool> : integral_hash<bool>
+        {
+        };
+
+        template <>
+        struct hash<char> : integral_hash<char>
+        {
+        };
+
+        template <>
+        struct hash<signed char> : integral_hash<signed char>
+        {
+        };
+
+        template <>
+        struct hash<unsigned char> : integral_hash<unsigned char>
+        {
+        };
+
+        template <>
+        struct hash<wchar_t> : integral_hash<wchar_t>
+        {
+        };
+
+        template <>
+        struct hash<short> : integral_hash<short>
+        {
+        };
+
+        template <>
+        struct hash<unsigned short> : integral_hash<unsigned short>
+        {
+        };
+
+        template <>
+        struct hash<int> : integral_hash<int>
+        {
+        };
+
+        template <>
+        struct hash<unsigned int> : integral_hash<unsigned int>
+        {
+        };
+
+        template <>
+        struct hash<long> : integral_hash<long>
+        {
+        };
+
+        template <>
+        struct hash<unsigned long> : integral_hash<unsigned long>
+        {
+        };
+
+        template <typename T>
+        struct hash<T*>
+        {
+            std::size_t operator()(T* value) const throw() { return reinterpret_cast<std::size_t>(value); }
+        };
+
+        template <>
+        struct hash<std::string>
+        {
+            // FNV-1a
+            std::size_t operator()(const std::string& value) const throw()
+            {
+                std::size_t result = static_cast<std::size_t>(2166136261UL);
+                for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+                {
+                    result ^= static_cast<unsigned char>(*it);
+                    result *= static_cast<std::size_t>(16777619UL);
+                }
+                return result;
+            }
+        };
+#endif
+    }
+}
@@ -0,0 +1,118 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include <pthread.h>
+
+#include <cassert>
+
+namespace ft
+{
+    namespace _internal
+    {
+        class mutex
+        {
+        private:
+            pthread_mutex_t handle;
+
+            mutex(const mutex&);
+            mutex& operator=(const mutex&);
+
+        public:
+            mutex() throw()
+            {
+                int result = pthread_mutex_init(&this->handle, 0);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            ~mutex() throw()
+            {
+                int result = pthread_mutex_destroy(&this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            void lock() throw()
+            {
+                int result = pthread_mutex_lock(&this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            bool try_lock() throw()
+            {
+                return pthread_mutex_trylock(&this->handle) == 0;
+            }
+
+            void unlock() throw()
+            {
+                int result = pthread_mutex_unlock(&this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            pthread_mutex_t* native_handle() throw() { return &this->handle; }
+        };
+
+        class mutex_guard
+        {
+        private:
+            mutex& m;
+
+            mutex_guard(const mutex_guard&);
+            mutex_guard& operator=(const mutex_guard&);
+
+        public:
+            explicit mutex_guard(mutex& m) throw()
+                : m(m)
+            {
+                this->m.lock();
+            }
+
+            ~mutex_guard() throw()
+            {
+                this->m.unlock();
+            }
+        };
+
+        class condition
+        {
+        private:
+            pthread_cond_t handle;
+
+            condition(const condition&);
+            condition& operator=(const condition&);
+
+        public:
+            condition() throw()
+            {
+                int result = pthread_cond_init(&this->handle, 0);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            ~condition() throw()
+            {
+                int result = pthread_cond_destroy(&this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            void wait(mutex& m) throw()
+            {
+                int result = pthread_cond_wait(&this->handle, m.native_handle());
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            void broadcast() throw()
+            {
+                int result = pthread_cond_broadcast(&this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+        };
+    }
+}
@@ -13,6 +13,14 @@ namespace ft
         {
         };
 
+        struct adopt_tag
+        {
+        };
+
+        struct nothrow_tag
+        {
+        };
+
         template <typename T, T Value>
         struct integral_constant
         {
@@ -273,6 +281,148 @@ namespace ft
             static const std::size_t value = N * scalar_count<T>::value;
         };
 
+        template <bool B, typename TTrue, typename TFalse>
+        struct conditional
+        {
+            typedef TTrue type;
+        };
+
+        template <typename TTrue, typename TFalse>
+        struct conditional<false, TTrue, TFalse>
+        {
+            typedef TFalse type;
+        };
+
+        template <typename T, typename U>
+        struct is_same : false_type
+        {
+        };
+
+        template <typename T>
+        struct is_same<T, T> : true_type
+        {
+        };
+
+        template <typename T>
+        struct is_class
+        {
+            typedef char (&yes)[1];
+            typedef char (&no)[2];
+
+            template <typename U>
+            static yes f(int U::*);
+            template <typename U>
+            static no f(...);
+
+            static const bool value = sizeof((f<T>)(0)) == sizeof(yes);
+        };
+
+        template <typename T, bool IsClass = is_class<T>::value>
+        struct _is_empty
+        {
+            static const bool value = false;
+        };
+
+        template <typename T>
+        struct _is_empty<T, true>
+        {
+#if defined(__GNUC__) && __cplusplus >= 201103L
+            // final classes can not be used as a base
+            static const bool value = __is_empty(T) && !__is_final(T);
+#else
+            struct derived : T
+            {
+                int i;
+            };
+
+            struct plain
+            {
+                int i;
+            };
+
+            static const bool value = sizeof(derived) == sizeof(plain);
+#endif
+        };
+
+        template <typename T>
+        struct is_empty : integral_constant<bool, _is_empty<T>::value>
+        {
+        };
+
+        template <typename T>
+        struct alignment_of
+        {
+            struct holder
+            {
+                char c;
+                T t;
+            };
+
+            static const std::size_t value = sizeof(holder) - sizeof(T);
+        };
+
+        union max_align
+        {
+            char c;
+            short s;
+            int i;
+            long l;
+            float f;
+            double d;
+            long double ld;
+            void* p;
+            void (*fp)();
+        };
+
+        template <std::size_t Align>
+        struct type_with_alignment
+        {
+            typedef typename conditional<
+                Align <= alignment_of<char>::value, char,
+                typename conditional<
+                    Align <= alignment_of<short>::value, short,
+                    typename conditional<
+                        Align <= alignment_of<int>::value, int,
+                        typename conditional<
+                            Align <= alignment_of<long>::value, long,
+                            typename conditional<
+                                Align <= alignment_of<double>::value, double,
+                                max_align>::type>::type>::type>::type>::type type;
+        };
+
+        inline bool is_power_of_two(std::size_t value) throw()
+        {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+
+        inline void* align_pointer(void* p, std::size_t align) throw()
+        {
+            const std::size_t address = reinterpret_cast<std::size_t>(p);
+            return reinterpret_cast<void*>((address + align - 1) & ~(align - 1));
+        }
+
+        // raw storage of Size bytes, over-aligned types get slack and are aligned at run time
+        template <std::size_t Size, std::size_t Align>
+        struct aligned_storage
+        {
+            static const std::size_t slack = Align > alignment_of<max_align>::value ? Align - alignment_of<max_align>::value : 0;
+
+            union type
+            {
+                unsigned char data[Size + slack];
+                typename type_with_alignment<Align>::type align;
+            };
+
+            static void* address(type& storage) throw()
+            {
+                if (slack == 0)
+                {
+                    return storage.data;
+                }
+                return align_pointer(storage.data, Align);
+            }
+        };
+
         template <typename TAlloc>
         struct allocate_guard
         {
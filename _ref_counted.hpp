@@ -4,6 +4,9 @@
 #pragma once
 
 #include "__ref_counted_base_posix.hpp"
+#include "_allocator.hpp"
+#include "_compressed_pair.hpp"
+#include "_exception.hpp"
 #include "bad_weak_ptr.hpp"
 
 #include <stdexcept>
@@ -39,23 +42,33 @@ namespace ft
             T* get_pointer() { return this->ptr; }
         };
 
+        // counts followed by a single pointer, the size a block with empty deleter and allocator must keep
+        template <typename TPointer>
+        struct _counted_layout : _counted_base
+        {
+            TPointer ptr;
+        };
+
         template <typename TPointer, typename TDelete>
         class _counted_impl_del : public _counted_base
         {
         private:
-            TPointer ptr;
-            TDelete del;
+            _internal::compressed_pair<TPointer, TDelete> data;
 
             _counted_impl_del(const _counted_impl_del&);
             _counted_impl_del& operator=(const _counted_impl_del&);
 
         public:
             explicit _counted_impl_del(TPointer ptr, const TDelete& del)
-                : ptr(ptr), del(del) {}
+                : data(ptr, del)
+            {
+                // Compile-time test
+                static_cast<void>(sizeof(char[!is_empty<TDelete>::value || sizeof(_counted_impl_del) == sizeof(_counted_layout<TPointer>) ? 1 : -1]));
+            }
 
             void dispose() throw()
             {
-                this->del(ptr);
+                this->get_deleter()(this->data.first());
             }
 
             void destroy() throw()
@@ -64,51 +77,54 @@ namespace ft
             }
 
         public:
-            TPointer get_pointer() { return this->ptr; }
+            TPointer get_pointer() { return this->data.first(); }
 
-            TDelete& get_deleter() { return this->del; }
-            const TDelete& get_deleter() const { return this->del; }
+            TDelete& get_deleter() { return this->data.second(); }
+            const TDelete& get_deleter() const { return this->data.second(); }
         };
 
         template <typename TPointer, typename TDelete, typename TAlloc>
         class _counted_impl_del_alloc : public _counted_base
         {
         private:
-            TPointer ptr;
-            TDelete del;
-            TAlloc alloc;
+            _internal::compressed_pair<TPointer, _internal::compressed_pair<TDelete, TAlloc> > data;
 
             _counted_impl_del_alloc(const _counted_impl_del_alloc&);
             _counted_impl_del_alloc& operator=(const _counted_impl_del_alloc&);
 
         public:
             explicit _counted_impl_del_alloc(TPointer ptr, const TDelete& del, const TAlloc& alloc)
-                : ptr(ptr), del(del), alloc(alloc) {}
+                : data(ptr, _internal::compressed_pair<TDelete, TAlloc>(del, alloc))
+            {
+                // Compile-time test
+                static_cast<void>(sizeof(char[!is_empty<TDelete>::value || !is_empty<TAlloc>::value || sizeof(_counted_impl_del_alloc) == sizeof(_counted_layout<TPointer>) ? 1 : -1]));
+                static_cast<void>(sizeof(char[!is_empty<TAlloc>::value || sizeof(_counted_impl_del_alloc) == sizeof(_counted_impl_del<TPointer, TDelete>) ? 1 : -1]));
+            }
 
             void dispose() throw()
             {
-                this->del(ptr);
+                this->get_deleter()(this->data.first());
             }
 
             void destroy() throw()
             {
                 typedef _counted_impl_del_alloc counted_type;
-                typedef typename TAlloc::template rebind<counted_type>::other alloc_type;
+                typedef typename _internal::rebind_alloc<TAlloc, counted_type>::type alloc_type;
 
-                alloc_type alloc_counted(this->alloc);
+                alloc_type alloc_counted(this->get_allocator());
                 static_cast<counted_type*>(this)->~counted_type();
                 alloc_counted.deallocate(this, 1);
             }
 
         public:
-            TPointer get_pointer() { return this->ptr; }
-            void init_pointer(TPointer ptr) { this->ptr = ptr; }
+            TPointer get_pointer() { return this->data.first(); }
+            void init_pointer(TPointer ptr) { this->data.first() = ptr; }
 
-            TDelete& get_deleter() { return this->del; }
-            const TDelete& get_deleter() const { return this->del; }
+            TDelete& get_deleter() { return this->data.second().first(); }
+            const TDelete& get_deleter() const { return this->data.second().first(); }
 
-            TAlloc& get_allocator() { return this->alloc; }
-            const TAlloc& get_allocator() const { return this->alloc; }
+            TAlloc& get_allocator() { return this->data.second().second(); }
+            const TAlloc& get_allocator() const { return this->data.second().second(); }
         };
 
         class _weak_count;
@@ -132,28 +148,28 @@ namespace ft
             explicit _shared_count(T* p)
                 : ptr(NULL)
             {
-                try
+                SMART_PTR_TRY
                 {
                     this->ptr = ::new _counted_impl<T>(p);
                 }
-                catch (...)
+                SMART_PTR_CATCH_ALL
                 {
                     ::delete p;
-                    throw;
+                    SMART_PTR_RETHROW;
                 }
             }
 
             template <typename TPointer, typename TDelete>
             _shared_count(TPointer p, TDelete del)
             {
-                try
+                SMART_PTR_TRY
                 {
                     this->ptr = ::new _counted_impl_del<TPointer, TDelete>(p, del);
                 }
-                catch (...)
+                SMART_PTR_CATCH_ALL
                 {
                     del(p);
-                    throw;
+                    SMART_PTR_RETHROW;
                 }
             }
 
@@ -161,21 +177,21 @@ namespace ft
             _shared_count(TPointer p, TDelete del, TAlloc alloc)
             {
                 typedef _counted_impl_del_alloc<TPointer, TDelete, TAlloc> counted_type;
-                typedef typename TAlloc::template rebind<counted_type>::other alloc_type;
+                typedef typename _internal::rebind_alloc<TAlloc, counted_type>::type alloc_type;
 
                 alloc_type alloc_counted(alloc);
                 _internal::allocate_guard<alloc_type> guard(alloc_counted);
 
                 counted_type* this_ptr = guard.get();
 
-                try
+                SMART_PTR_TRY
                 {
                     ::new (this_ptr) counted_type(p, del, alloc);
                 }
-                catch (...)
+                SMART_PTR_CATCH_ALL
                 {
                     del(p);
-                    throw;
+                    SMART_PTR_RETHROW;
                 }
 
                 this->ptr = this_ptr;
@@ -183,11 +199,16 @@ namespace ft
             }
 
             // Internal BEGIN
+            // unlike (p, del), `p` is left to the caller if this throws
+            template <typename TPointer, typename TDelete>
+            _shared_count(_internal::internal_tag, TPointer p, const TDelete& del)
+                : ptr(::new _counted_impl_del<TPointer, TDelete>(p, del)) {}
+
             template <typename T, typename TStorage, typename TInitializer>
             _shared_count(_internal::internal_tag, T** pp, const TStorage& storage, TInitializer init)
             {
                 typedef _counted_impl_del_alloc<T*, TStorage, typename TStorage::allocate_type> counted_type;
-                typedef typename TStorage::allocate_type::template rebind<counted_type>::other alloc_type;
+                typedef typename _internal::rebind_alloc<typename TStorage::allocate_type, counted_type>::type alloc_type;
 
                 alloc_type alloc_counted(storage.get_allocator());
                 _internal::allocate_guard<alloc_type> guard(alloc_counted);
@@ -225,6 +246,9 @@ namespace ft
 
             explicit _shared_count(const _weak_count& that);
 
+            // empty instead of throwing if expired
+            _shared_count(const _weak_count& that, _internal::nothrow_tag) throw();
+
             ~_shared_count()
             {
                 if (this->ptr != NULL)
@@ -269,7 +293,7 @@ namespace ft
 
             bool unique() const throw()
             {
-                return this->use_count() == 1;
+                return this->ptr != NULL && this->ptr->unique();
             }
 
             bool empty() const throw()
@@ -283,6 +307,19 @@ namespace ft
             }
 
             bool operator==(const _weak_count& that) const throw();
+
+            _counted_base* get_counted() const throw()
+            {
+                return this->ptr;
+            }
+
+            // gives up the reference without releasing it
+            _counted_base* detach() throw()
+            {
+                _counted_base* tmp = this->ptr;
+                this->ptr = NULL;
+                return tmp;
+            }
         };
 
         class _weak_count
@@ -297,6 +334,9 @@ namespace ft
             _weak_count() throw()
                 : ptr(NULL) {}
 
+            explicit _weak_count(_counted_base* ptr) throw()
+                : ptr(ptr) {}
+
             _weak_count(const _shared_count& that) throw()
                 : ptr(that.ptr)
             {
@@ -384,6 +424,11 @@ namespace ft
             {
                 return this->ptr == that.ptr;
             }
+
+            _counted_base* get_counted() const throw()
+            {
+                return this->ptr;
+            }
         };
 
         inline _shared_count::_shared_count(const _weak_count& that)
@@ -391,7 +436,16 @@ namespace ft
         {
             if (this->ptr == NULL || !this->ptr->add_ref_lock())
             {
-                throw bad_weak_ptr();
+                SMART_PTR_THROW(bad_weak_ptr());
+            }
+        }
+
+        inline _shared_count::_shared_count(const _weak_count& that, _internal::nothrow_tag) throw()
+            : ptr(that.ptr)
+        {
+            if (this->ptr != NULL && !this->ptr->add_ref_lock())
+            {
+                this->ptr = NULL;
             }
         }
 
@@ -0,0 +1,256 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_mutex.hpp"
+#include "_ptr_element.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#ifndef SMART_PTR_ARENA_CHUNK_SIZE
+#define SMART_PTR_ARENA_CHUNK_SIZE (64 << 10)
+#endif
+
+namespace ft
+{
+    namespace _internal
+    {
+        // header of an arena chunk, the data follows it
+        union arena_chunk
+        {
+            struct
+            {
+                arena_chunk* next;
+                std::size_t size;
+            } link;
+            max_align align;
+
+            unsigned char* begin() throw() { return reinterpret_cast<unsigned char*>(this + 1); }
+            unsigned char* end() throw() { return this->begin() + this->link.size; }
+        };
+    }
+
+    // monotonic memory for objects that die together.
+    // deallocation does nothing, reset() rewinds to the first chunk in O(1) and keeps the chunks.
+    // in debug builds reset() and the destructor assert that every block was deallocated,
+    // that is no shared_ptr allocated from this arena is still alive.
+    class arena
+    {
+    private:
+        _internal::mutex lock;
+        _internal::arena_chunk* head;
+        _internal::arena_chunk* tail;
+        _internal::arena_chunk* current;
+        unsigned char* cursor;
+        unsigned char* end;
+        std::size_t chunk_size;
+        std::size_t live; // blocks not deallocated yet, counted with or without NDEBUG
+
+        arena(const arena&);
+        arena& operator=(const arena&);
+
+    public:
+        explicit arena(std::size_t chunk_size = SMART_PTR_ARENA_CHUNK_SIZE) throw()
+            : lock(), head(NULL), tail(NULL), current(NULL), cursor(NULL), end(NULL), chunk_size(chunk_size), live(0)
+        {
+        }
+
+        ~arena() throw()
+        {
+            assert(this->live_blocks() == 0 && "shared_ptr outlives its arena");
+            _internal::arena_chunk* chunk = this->head;
+            while (chunk != NULL)
+            {
+                _internal::arena_chunk* next = chunk->link.next;
+                ::operator delete(chunk);
+                chunk = next;
+            }
+        }
+
+        void* allocate(std::size_t bytes, std::size_t align)
+        {
+            assert(_internal::is_power_of_two(align));
+
+            _internal::mutex_guard guard(this->lock);
+            unsigned char* p = static_cast<unsigned char*>(_internal::align_pointer(this->cursor, align));
+            if (this->cursor == NULL || p > this->end || static_cast<std::size_t>(this->end - p) < bytes)
+            {
+                p = this->next_chunk(bytes, align);
+            }
+            this->cursor = p + bytes;
+#ifdef __GNUC__
+            __atomic_add_fetch(&this->live, 1, __ATOMIC_RELAXED);
+#else
+            ++this->live;
+#endif
+            return p;
+        }
+
+        void deallocate(void* p, std::size_t bytes) throw()
+        {
+            static_cast<void>(p);
+            static_cast<void>(bytes);
+#ifdef __GNUC__
+            const std::size_t previous = __atomic_fetch_sub(&this->live, 1, __ATOMIC_RELAXED);
+#else
+            _internal::mutex_guard guard(this->lock);
+            const std::size_t previous = this->live--;
+#endif
+            assert(previous != 0);
+            static_cast<void>(previous);
+        }
+
+        // every block must have been deallocated
+        void reset() throw()
+        {
+            _internal::mutex_guard guard(this->lock);
+            assert(this->live_blocks() == 0 && "shared_ptr outlives its arena");
+            this->current = NULL;
+            this->cursor = NULL;
+            this->end = NULL;
+        }
+
+    private:
+        std::size_t live_blocks() const throw()
+        {
+#ifdef __GNUC__
+            return __atomic_load_n(&this->live, __ATOMIC_RELAXED);
+#else
+            return this->live;
+#endif
+        }
+
+        // first chunk after the current one with room, a new one at the tail if none
+        unsigned char* next_chunk(std::size_t bytes, std::size_t align)
+        {
+            const std::size_t slack = align > _internal::alignment_of<_internal::max_align>::value ? align : 0;
+            if (bytes > static_cast<std::size_t>(-1) - sizeof(_internal::arena_chunk) - slack)
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+            const std::size_t need = bytes + slack;
+
+            // chunks skipped here stay unused until the next reset
+            _internal::arena_chunk* chunk = this->current == NULL ? this->head : this->current->link.next;
+            while (chunk != NULL && chunk->link.size < need)
+            {
+                chunk = chunk->link.next;
+            }
+
+            if (chunk == NULL)
+            {
+                const std::size_t size = need > this->chunk_size ? need : this->chunk_size;
+                chunk = static_cast<_internal::arena_chunk*>(::operator new(sizeof(_internal::arena_chunk) + size));
+                chunk->link.next = NULL;
+                chunk->link.size = size;
+                if (this->tail == NULL)
+                {
+                    this->head = chunk;
+                }
+                else
+                {
+                    this->tail->link.next = chunk;
+                }
+                this->tail = chunk;
+            }
+
+            this->current = chunk;
+            this->end = chunk->end();
+            return static_cast<unsigned char*>(_internal::align_pointer(chunk->begin(), align));
+        }
+    };
+
+    // allocator drawing from an arena, for allocate_shared.
+    // destroying a control block runs the destructors only, the memory is reclaimed by arena::reset.
+    template <typename T>
+    class arena_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef arena_allocator<U> other;
+        };
+
+    private:
+        template <typename U>
+        friend class arena_allocator;
+
+    private:
+        arena* source;
+
+    public:
+        explicit arena_allocator(arena& source) throw()
+            : source(&source) {}
+
+        arena_allocator(const arena_allocator& that) throw()
+            : source(that.source) {}
+
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& that) throw()
+            : source(that.source) {}
+
+        ~arena_allocator() throw() {}
+
+        arena_allocator& operator=(const arena_allocator& that) throw()
+        {
+            this->source = that.source;
+            return *this;
+        }
+
+        arena& get_arena() const throw()
+        {
+            return *this->source;
+        }
+
+        T* allocate(std::size_t n, const void* = NULL)
+        {
+            if (n > this->max_size())
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+
+            return static_cast<T*>(this->source->allocate(n * sizeof(T), _internal::alignment_of<T>::value));
+        }
+
+        void deallocate(T* p, std::size_t n) throw()
+        {
+            this->source->deallocate(p, n * sizeof(T));
+        }
+
+        std::size_t max_size() const throw()
+        {
+            return static_cast<std::size_t>(-1) / sizeof(T);
+        }
+
+        T* address(T& x) const throw() { return _internal::addressof(x); }
+        const T* address(const T& x) const throw() { return _internal::addressof(x); }
+
+        void construct(T* p, const T& value) { ::new (static_cast<void*>(p)) T(value); }
+        void destroy(T* p) { p->~T(); }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) throw()
+    {
+        return &lhs.get_arena() == &rhs.get_arena();
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) throw()
+    {
+        return &lhs.get_arena() != &rhs.get_arena();
+    }
+}
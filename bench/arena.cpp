@@ -0,0 +1,101 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// simulated requests that build a small object graph, use it and drop it:
+// allocate_shared with an arena_allocator and one reset() per request, against make_shared
+
+#include "bench.hpp"
+#include "count_allocations.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t requests = 100000;
+    const std::size_t objects_per_request = 64;
+
+    struct node
+    {
+        ft::shared_ptr<node> next;
+        long value;
+
+        explicit node(long value)
+            : next(), value(value) {}
+    };
+
+    struct from_arena
+    {
+        ft::arena* source;
+
+        ft::shared_ptr<node> operator()(long value) const
+        {
+            return ft::allocate_shared<node>(ft::arena_allocator<node>(*this->source), value);
+        }
+
+        void end_request() const throw()
+        {
+            this->source->reset();
+        }
+    };
+
+    struct from_make_shared
+    {
+        ft::shared_ptr<node> operator()(long value) const
+        {
+            return ft::make_shared<node>(value);
+        }
+
+        void end_request() const throw() {}
+    };
+
+    // each request links a list of objects, walks it and lets it go
+    template <typename TSource>
+    void run(const char* name, const TSource& source)
+    {
+        std::vector<ft::shared_ptr<node> > roots;
+        roots.reserve(objects_per_request);
+        long sum = 0;
+
+        const std::size_t calls = bench::allocations().calls;
+        const double start = bench::now();
+        for (std::size_t r = 0; r < requests; r++)
+        {
+            ft::shared_ptr<node> head;
+            for (std::size_t i = 0; i < objects_per_request; i++)
+            {
+                ft::shared_ptr<node> n = source(static_cast<long>(i));
+                n->next = head;
+                head = n;
+                roots.push_back(n);
+            }
+            for (node* n = head.get(); n != NULL; n = n->next.get())
+            {
+                sum += n->value;
+            }
+            roots.clear();
+            head.reset();
+            source.end_request();
+        }
+        const double seconds = bench::now() - start;
+
+        bench::report(name, requests * objects_per_request, seconds);
+        std::printf("%-40s %12s %10.2f us\n", "  per request", "", seconds * 1e6 / static_cast<double>(requests));
+        std::printf("%-40s %12lu\n", "  operator new calls", static_cast<unsigned long>(bench::allocations().calls - calls));
+        bench::keep(sum);
+    }
+}
+
+int main()
+{
+    char title[64];
+    std::sprintf(title, "%lu requests of %lu objects", static_cast<unsigned long>(requests), static_cast<unsigned long>(objects_per_request));
+    bench::header(title);
+
+    ft::arena arena;
+    from_arena arena_source = {&arena};
+    run("allocate_shared, arena_allocator", arena_source);
+    run("make_shared", from_make_shared());
+    return 0;
+}
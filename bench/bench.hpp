@@ -0,0 +1,66 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+// helpers of the standalone benchmarks in this directory.
+// each one builds on its own from the repository root:
+//
+//   g++ -std=c++98 -O2 -I. bench/<name>.cpp -o <name> -lpthread
+//
+// NDEBUG must stay undefined, _counted_base takes its mutex inside assert().
+
+#include <pthread.h>
+#include <time.h>
+
+#include <cstddef>
+#include <cstdio>
+
+namespace bench
+{
+    // monotonic seconds
+    inline double now() throw()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+    }
+
+    inline void header(const char* title) throw()
+    {
+        std::printf("\n%s\n%-40s %12s %10s\n", title, "case", "ops", "ns/op");
+    }
+
+    inline void report(const char* name, std::size_t ops, double seconds) throw()
+    {
+        std::printf("%-40s %12lu %10.2f\n", name, static_cast<unsigned long>(ops), ops == 0 ? 0.0 : seconds * 1e9 / static_cast<double>(ops));
+    }
+
+    // keeps a computed value alive across the optimizer
+    template <typename T>
+    void keep(const T& value) throw()
+    {
+        __asm__ __volatile__("" : : "r"(&value) : "memory");
+    }
+
+    // runs fn(arg) on `n` threads at once and returns the wall time
+    inline double run_threads(std::size_t n, void* (*fn)(void*), void* arg)
+    {
+        pthread_t threads[64];
+        if (n > sizeof(threads) / sizeof(threads[0]))
+        {
+            n = sizeof(threads) / sizeof(threads[0]);
+        }
+
+        const double start = now();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            pthread_create(&threads[i], NULL, fn, arg);
+        }
+        for (std::size_t i = 0; i < n; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        return now() - start;
+    }
+}
@@ -0,0 +1,81 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// collect_cycles() on a ring of collectable nodes with a second edge to a farther node:
+// its pause and the nodes it goes through per second, once while the ring is still
+// reachable and nothing is collected, once after the last outside reference is gone.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    struct node
+    {
+        ft::shared_ptr<node> next;
+        ft::shared_ptr<node> skip;
+        long value;
+
+        explicit node(long value)
+            : next(), skip(), value(value) {}
+
+        void trace(ft::cycle_tracer& tracer) const
+        {
+            tracer(this->next);
+            tracer(this->skip);
+        }
+    };
+
+    ft::shared_ptr<node> ring(std::size_t n)
+    {
+        std::vector<ft::shared_ptr<node> > nodes;
+        nodes.reserve(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            nodes.push_back(ft::make_shared_collectable<node>(static_cast<long>(i)));
+        }
+        for (std::size_t i = 0; i < n; i++)
+        {
+            nodes[i]->next = nodes[(i + 1) % n];
+            nodes[i]->skip = nodes[(i * 7 + 3) % n];
+        }
+        return nodes[0];
+    }
+
+    void pause(const char* name, std::size_t n, std::size_t expected)
+    {
+        const double start = bench::now();
+        const std::size_t collected = ft::collect_cycles();
+        const double seconds = bench::now() - start;
+
+        bench::report(name, n, seconds);
+        std::printf("%-40s %12lu %10.2f us\n", "  collected, pause", static_cast<unsigned long>(collected), seconds * 1e6);
+        if (collected != expected)
+        {
+            std::printf("%-40s %12lu\n", "  expected", static_cast<unsigned long>(expected));
+        }
+    }
+}
+
+int main()
+{
+    const std::size_t sizes[] = {1000, 10000, 100000, 1000000};
+
+    for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        const std::size_t n = sizes[s];
+        char title[64];
+        std::sprintf(title, "ring of %lu nodes", static_cast<unsigned long>(n));
+        bench::header(title);
+
+        ft::shared_ptr<node> root = ring(n);
+        pause("reachable", n, 0);
+
+        root.reset();
+        pause("garbage", n, n);
+    }
+    return 0;
+}
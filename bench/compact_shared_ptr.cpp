@@ -0,0 +1,109 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// a 10M element index of make_shared nodes, held as std::vector<shared_ptr> and as
+// std::vector<compact_shared_ptr>: footprint of the index, in order and shuffled scans
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t element_count = 10000000;
+    const std::size_t passes = 5;
+
+    struct node
+    {
+        long value;
+
+        explicit node(long value)
+            : value(value) {}
+    };
+
+    template <typename TIndex>
+    void scan(const char* name, const TIndex& index, const std::vector<std::size_t>& order)
+    {
+        long sum = 0;
+        double start = bench::now();
+        for (std::size_t p = 0; p < passes; p++)
+        {
+            for (std::size_t i = 0; i < index.size(); i++)
+            {
+                sum += index[i]->value;
+            }
+        }
+        char label[64];
+        std::sprintf(label, "%s, in order", name);
+        bench::report(label, passes * index.size(), bench::now() - start);
+
+        start = bench::now();
+        for (std::size_t p = 0; p < passes; p++)
+        {
+            for (std::size_t i = 0; i < order.size(); i++)
+            {
+                sum += index[order[i]]->value;
+            }
+        }
+        std::sprintf(label, "%s, shuffled", name);
+        bench::report(label, passes * order.size(), bench::now() - start);
+        bench::keep(sum);
+    }
+}
+
+int main()
+{
+    std::vector<ft::shared_ptr<node> > wide;
+    wide.reserve(element_count);
+    for (std::size_t i = 0; i < element_count; i++)
+    {
+        wide.push_back(ft::make_shared<node>(static_cast<long>(i)));
+    }
+
+    // the same nodes, one word per entry
+    std::vector<ft::compact_shared_ptr<node> > compact;
+    compact.reserve(element_count);
+    for (std::size_t i = 0; i < element_count; i++)
+    {
+        compact.push_back(ft::compact_shared_ptr<node>(wide[i]));
+    }
+
+    std::vector<std::size_t> order(element_count);
+    unsigned seed = 1;
+    for (std::size_t i = 0; i < element_count; i++)
+    {
+        order[i] = i;
+    }
+    for (std::size_t i = element_count - 1; i > 0; i--)
+    {
+        seed = seed * 1103515245u + 12345u;
+        std::swap(order[i], order[seed % (i + 1)]);
+    }
+
+    std::printf("index bytes: shared_ptr %lu MiB, compact_shared_ptr %lu MiB\n",
+                static_cast<unsigned long>(wide.size() * sizeof(wide[0]) >> 20),
+                static_cast<unsigned long>(compact.size() * sizeof(compact[0]) >> 20));
+
+    bench::header("10M element index");
+    scan("shared_ptr", wide, order);
+    scan("compact_shared_ptr", compact, order);
+
+    // copying the index touches every count
+    double start = bench::now();
+    {
+        std::vector<ft::shared_ptr<node> > copy(wide);
+        bench::keep(copy.size());
+    }
+    bench::report("shared_ptr, copy and release", element_count, bench::now() - start);
+
+    start = bench::now();
+    {
+        std::vector<ft::compact_shared_ptr<node> > copy(compact);
+        bench::keep(copy.size());
+    }
+    bench::report("compact_shared_ptr, copy and release", element_count, bench::now() - start);
+    return 0;
+}
@@ -0,0 +1,193 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// allocator calls and bytes of each shared_ptr construction form, next to std::shared_ptr.
+// "new" counts calls of the global operator new, "alloc" those of the counting allocator
+// given to allocate_shared or to shared_ptr(p, del, alloc), which does not go through it.
+// build with -std=c++11 or later for the std::shared_ptr column, c++20 for its arrays.
+
+#include "bench.hpp"
+#include "count_allocations.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace
+{
+    bench::allocation_count allocator_count = {0, 0};
+
+    template <typename T>
+    class counting_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef counting_allocator<U> other;
+        };
+
+    public:
+        counting_allocator() throw() {}
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U>&) throw() {}
+
+        T* allocate(std::size_t n, const void* = NULL)
+        {
+            allocator_count.calls++;
+            allocator_count.bytes += n * sizeof(T);
+            void* p = std::malloc(n * sizeof(T));
+            if (p == NULL)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t) throw()
+        {
+            std::free(p);
+        }
+
+        std::size_t max_size() const throw()
+        {
+            return static_cast<std::size_t>(-1) / sizeof(T);
+        }
+
+        void construct(T* p, const T& value) { ::new (static_cast<void*>(p)) T(value); }
+        void destroy(T* p) { p->~T(); }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) throw()
+    {
+        return true;
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) throw()
+    {
+        return false;
+    }
+
+    struct int_deleter
+    {
+        void operator()(int* p) const throw()
+        {
+            delete p;
+        }
+    };
+
+    // what one construction and destruction of a form costs
+    struct footprint
+    {
+        bench::allocation_count global;
+        bench::allocation_count allocator;
+    };
+
+    footprint measure(void (*form)())
+    {
+        const bench::allocation_count global = bench::allocations();
+        const bench::allocation_count allocator = allocator_count;
+        form();
+
+        footprint result;
+        result.global.calls = bench::allocations().calls - global.calls;
+        result.global.bytes = bench::allocations().bytes - global.bytes;
+        result.allocator.calls = allocator_count.calls - allocator.calls;
+        result.allocator.bytes = allocator_count.bytes - allocator.bytes;
+        return result;
+    }
+
+    void print_cell(const footprint* f)
+    {
+        if (f == NULL)
+        {
+            std::printf(" %5s %6s %5s %6s", "-", "-", "-", "-");
+            return;
+        }
+        std::printf(" %5lu %6lu %5lu %6lu", static_cast<unsigned long>(f->global.calls), static_cast<unsigned long>(f->global.bytes),
+                    static_cast<unsigned long>(f->allocator.calls), static_cast<unsigned long>(f->allocator.bytes));
+    }
+
+    void row(const char* name, void (*ft_form)(), void (*std_form)())
+    {
+        const footprint ft_footprint = measure(ft_form);
+        std::printf("%-32s", name);
+        print_cell(&ft_footprint);
+        std::printf("  |");
+        if (std_form == NULL)
+        {
+            print_cell(NULL);
+        }
+        else
+        {
+            const footprint std_footprint = measure(std_form);
+            print_cell(&std_footprint);
+        }
+        std::printf("\n");
+    }
+
+    void ft_pointer() { ft::shared_ptr<int> p(new int(1)); }
+    void ft_deleter() { ft::shared_ptr<int> p(new int(1), int_deleter()); }
+    void ft_deleter_allocator() { ft::shared_ptr<int> p(new int(1), int_deleter(), counting_allocator<int>()); }
+    void ft_make_shared() { ft::shared_ptr<int> p = ft::make_shared<int>(1); }
+    void ft_allocate_shared() { ft::shared_ptr<int> p = ft::allocate_shared<int>(counting_allocator<int>(), 1); }
+    void ft_make_shared_bounded() { ft::shared_ptr<int[8]> p = ft::make_shared<int[8]>(); }
+    void ft_allocate_shared_bounded() { ft::shared_ptr<int[8]> p = ft::allocate_shared<int[8]>(counting_allocator<int>()); }
+    void ft_make_shared_unbounded() { ft::shared_ptr<int[]> p = ft::make_shared<int[]>(8); }
+    void ft_allocate_shared_unbounded() { ft::shared_ptr<int[]> p = ft::allocate_shared<int[]>(counting_allocator<int>(), 8); }
+
+#if __cplusplus >= 201103L
+    void std_pointer() { std::shared_ptr<int> p(new int(1)); }
+    void std_deleter() { std::shared_ptr<int> p(new int(1), int_deleter()); }
+    void std_deleter_allocator() { std::shared_ptr<int> p(new int(1), int_deleter(), counting_allocator<int>()); }
+    void std_make_shared() { std::shared_ptr<int> p = std::make_shared<int>(1); }
+    void std_allocate_shared() { std::shared_ptr<int> p = std::allocate_shared<int>(counting_allocator<int>(), 1); }
+#else
+    void (*const std_pointer)() = NULL;
+    void (*const std_deleter)() = NULL;
+    void (*const std_deleter_allocator)() = NULL;
+    void (*const std_make_shared)() = NULL;
+    void (*const std_allocate_shared)() = NULL;
+#endif
+
+#if defined(__cpp_lib_shared_ptr_arrays) && __cpp_lib_shared_ptr_arrays >= 201707L
+    void std_make_shared_bounded() { std::shared_ptr<int[8]> p = std::make_shared<int[8]>(); }
+    void std_allocate_shared_bounded() { std::shared_ptr<int[8]> p = std::allocate_shared<int[8]>(counting_allocator<int>()); }
+    void std_make_shared_unbounded() { std::shared_ptr<int[]> p = std::make_shared<int[]>(8); }
+    void std_allocate_shared_unbounded() { std::shared_ptr<int[]> p = std::allocate_shared<int[]>(counting_allocator<int>(), 8); }
+#else
+    void (*const std_make_shared_bounded)() = NULL;
+    void (*const std_allocate_shared_bounded)() = NULL;
+    void (*const std_make_shared_unbounded)() = NULL;
+    void (*const std_allocate_shared_unbounded)() = NULL;
+#endif
+}
+
+int main()
+{
+    std::printf("%-32s %27s  | %27s\n", "", "ft::shared_ptr", "std::shared_ptr");
+    std::printf("%-32s %5s %6s %5s %6s  | %5s %6s %5s %6s\n", "form", "new", "bytes", "alloc", "bytes", "new", "bytes", "alloc", "bytes");
+    row("shared_ptr(U*)", &ft_pointer, std_pointer);
+    row("shared_ptr(U*, del)", &ft_deleter, std_deleter);
+    row("shared_ptr(U*, del, alloc)", &ft_deleter_allocator, std_deleter_allocator);
+    row("make_shared<int>", &ft_make_shared, std_make_shared);
+    row("allocate_shared<int>", &ft_allocate_shared, std_allocate_shared);
+    row("make_shared<int[8]>", &ft_make_shared_bounded, std_make_shared_bounded);
+    row("allocate_shared<int[8]>", &ft_allocate_shared_bounded, std_allocate_shared_bounded);
+    row("make_shared<int[]>(8)", &ft_make_shared_unbounded, std_make_shared_unbounded);
+    row("allocate_shared<int[]>(8)", &ft_allocate_shared_unbounded, std_allocate_shared_unbounded);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+// replaces the global operator new and delete to count calls and bytes.
+// include it in the one translation unit of a benchmark.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// the replacements are not inlined, gcc would otherwise see free() meet operator new
+#ifdef __GNUC__
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+#if __cplusplus >= 201103L
+#define BENCH_THROW_BAD_ALLOC
+#else
+#define BENCH_THROW_BAD_ALLOC throw(std::bad_alloc)
+#endif
+
+namespace bench
+{
+    // since the start of the program, not thread safe
+    struct allocation_count
+    {
+        std::size_t calls;
+        std::size_t bytes;
+    };
+
+    inline allocation_count& allocations() throw()
+    {
+        static allocation_count value = {0, 0};
+        return value;
+    }
+}
+
+BENCH_NOINLINE void* operator new(std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+    bench::allocations().calls++;
+    bench::allocations().bytes += size;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+BENCH_NOINLINE void* operator new[](std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+    return ::operator new(size);
+}
+
+BENCH_NOINLINE void operator delete(void* p) throw()
+{
+    std::free(p);
+}
+
+BENCH_NOINLINE void operator delete[](void* p) throw()
+{
+    std::free(p);
+}
+
+#if __cplusplus >= 201402L
+BENCH_NOINLINE void operator delete(void* p, std::size_t) throw()
+{
+    std::free(p);
+}
+
+BENCH_NOINLINE void operator delete[](void* p, std::size_t) throw()
+{
+    std::free(p);
+}
+#endif
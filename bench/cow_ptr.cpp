@@ -0,0 +1,116 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// read-heavy use of cow_ptr with occasional writes, against copy-on-write
+// rolled by hand on shared_ptr::use_count()
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+
+namespace
+{
+    const std::size_t ops_per_thread = 10000000;
+    const std::size_t write_every = 1000;
+    const std::size_t snapshot_every = 10000;
+
+    struct config
+    {
+        long values[16];
+
+        config()
+        {
+            for (std::size_t i = 0; i < 16; i++)
+            {
+                this->values[i] = static_cast<long>(i);
+            }
+        }
+    };
+
+    // the pattern cow_ptr replaces
+    class hand_rolled
+    {
+    private:
+        ft::shared_ptr<config> ptr;
+
+    public:
+        explicit hand_rolled(const config& value)
+            : ptr(ft::make_shared<config>(value)) {}
+
+        const config& read() const { return *this->ptr; }
+
+        config& write()
+        {
+            if (this->ptr.use_count() != 1)
+            {
+                this->ptr = ft::make_shared<config>(static_cast<const config&>(*this->ptr));
+            }
+            return *this->ptr;
+        }
+    };
+
+    // every thread works on its own handle, taking a snapshot of it now and then
+    template <typename THandle>
+    void* mix(void*)
+    {
+        THandle handle((config()));
+        THandle snapshot = handle;
+        long sum = 0;
+        for (std::size_t i = 0; i < ops_per_thread; i++)
+        {
+            if (i % snapshot_every == 0)
+            {
+                snapshot = handle;
+            }
+            if (i % write_every == 0)
+            {
+                handle.write().values[i % 16] = static_cast<long>(i);
+            }
+            else
+            {
+                sum += handle.read().values[i % 16];
+            }
+        }
+        bench::keep(sum);
+        return NULL;
+    }
+
+    // write() on a handle nobody shares: the uniqueness check alone
+    template <typename THandle>
+    void* unshared_writes(void*)
+    {
+        THandle handle((config()));
+        for (std::size_t i = 0; i < ops_per_thread; i++)
+        {
+            handle.write().values[i % 16] = static_cast<long>(i);
+        }
+        bench::keep(handle.read().values[0]);
+        return NULL;
+    }
+
+    void run(const char* name, void* (*fn)(void*), std::size_t threads)
+    {
+        const double seconds = bench::run_threads(threads, fn, NULL);
+        bench::report(name, threads * ops_per_thread, seconds);
+    }
+}
+
+int main()
+{
+    const std::size_t thread_counts[] = {1, 4};
+
+    for (std::size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        const std::size_t threads = thread_counts[t];
+        char title[64];
+        std::sprintf(title, "%lu thread(s), 1 write in %lu", static_cast<unsigned long>(threads), static_cast<unsigned long>(write_every));
+        bench::header(title);
+
+        run("mix cow_ptr", &mix<ft::cow_ptr<config> >, threads);
+        run("mix use_count() == 1", &mix<hand_rolled>, threads);
+        run("unshared write cow_ptr", &unshared_writes<ft::cow_ptr<config> >, threads);
+        run("unshared write use_count() == 1", &unshared_writes<hand_rolled>, threads);
+    }
+    return 0;
+}
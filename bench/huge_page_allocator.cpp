@@ -0,0 +1,61 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// scans of a 512 MiB shared array from allocate_shared with huge_page_allocator and with
+// std::allocator: in order, then gathering at random indexes, where 4 KiB pages miss the TLB.
+// hugetlb pages need a reserved pool (vm.nr_hugepages), transparent ones need
+// /sys/kernel/mm/transparent_hugepage/enabled set to always or madvise.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace
+{
+    const std::size_t element_count = (512UL << 20) / sizeof(long);
+    const std::size_t gathers = 20000000;
+
+    template <typename TAlloc>
+    void scan(const char* name)
+    {
+        double start = bench::now();
+        ft::shared_ptr<long[]> array = ft::allocate_shared<long[]>(TAlloc(), element_count);
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            array[i] = static_cast<long>(i);
+        }
+        char label[64];
+        std::sprintf(label, "%s, allocate and fill", name);
+        bench::report(label, element_count, bench::now() - start);
+
+        long sum = 0;
+        start = bench::now();
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            sum += array[i];
+        }
+        std::sprintf(label, "%s, in order", name);
+        bench::report(label, element_count, bench::now() - start);
+
+        unsigned seed = 1;
+        start = bench::now();
+        for (std::size_t i = 0; i < gathers; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            sum += array[(seed >> 4) % element_count];
+        }
+        std::sprintf(label, "%s, random", name);
+        bench::report(label, gathers, bench::now() - start);
+        bench::keep(sum);
+    }
+}
+
+int main()
+{
+    bench::header("512 MiB array of long");
+    scan<ft::huge_page_allocator<long> >("huge_page_allocator");
+    scan<std::allocator<long> >("std::allocator");
+    return 0;
+}
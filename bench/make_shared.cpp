@@ -0,0 +1,118 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// allocation rate and cache misses of the make_shared block against shared_ptr(new T):
+// create/release cycles with their allocator calls and bytes, then sums over objects
+// visited in a shuffled order, where each access misses the cache.
+// with -std=c++11 or later, std::make_shared is measured as well.
+
+#include "bench.hpp"
+#include "count_allocations.hpp"
+#include "smart_ptr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <memory>
+#endif
+
+namespace
+{
+    const std::size_t cycles = 5000000;
+    const std::size_t object_count = 2000000;
+    const std::size_t passes = 10;
+
+    struct make_shared_form
+    {
+        typedef ft::shared_ptr<int> result_type;
+
+        ft::shared_ptr<int> operator()(int value) const { return ft::make_shared<int>(value); }
+    };
+
+    struct new_form
+    {
+        typedef ft::shared_ptr<int> result_type;
+
+        ft::shared_ptr<int> operator()(int value) const { return ft::shared_ptr<int>(new int(value)); }
+    };
+
+#if __cplusplus >= 201103L
+    struct std_form
+    {
+        typedef std::shared_ptr<int> result_type;
+
+        std::shared_ptr<int> operator()(int value) const { return std::make_shared<int>(value); }
+    };
+#endif
+
+    template <typename TForm>
+    void allocation_rate(const char* name, TForm form)
+    {
+        const bench::allocation_count before = bench::allocations();
+        const double start = bench::now();
+        for (std::size_t i = 0; i < cycles; i++)
+        {
+            bench::keep(*form(static_cast<int>(i)));
+        }
+        const double seconds = bench::now() - start;
+        bench::report(name, cycles, seconds);
+        std::printf("%-40s %12.1f %10.1f\n", "  new calls and bytes per object",
+                    static_cast<double>(bench::allocations().calls - before.calls) / cycles,
+                    static_cast<double>(bench::allocations().bytes - before.bytes) / cycles);
+    }
+
+    template <typename TForm>
+    void shuffled_sum(const char* name, TForm form, const std::vector<std::size_t>& order)
+    {
+        std::vector<typename TForm::result_type> objects;
+        objects.reserve(object_count);
+        for (std::size_t i = 0; i < object_count; i++)
+        {
+            objects.push_back(form(static_cast<int>(i)));
+        }
+
+        long sum = 0;
+        const double start = bench::now();
+        for (std::size_t p = 0; p < passes; p++)
+        {
+            for (std::size_t i = 0; i < order.size(); i++)
+            {
+                sum += *objects[order[i]];
+            }
+        }
+        bench::report(name, passes * object_count, bench::now() - start);
+        bench::keep(sum);
+    }
+}
+
+int main()
+{
+    bench::header("create and release an int");
+    allocation_rate("ft::make_shared", make_shared_form());
+    allocation_rate("ft::shared_ptr(new int)", new_form());
+#if __cplusplus >= 201103L
+    allocation_rate("std::make_shared", std_form());
+#endif
+
+    std::vector<std::size_t> order(object_count);
+    for (std::size_t i = 0; i < object_count; i++)
+    {
+        order[i] = i;
+    }
+    unsigned seed = 1;
+    for (std::size_t i = object_count - 1; i > 0; i--)
+    {
+        seed = seed * 1103515245u + 12345u;
+        std::swap(order[i], order[seed % (i + 1)]);
+    }
+
+    bench::header("sum of 2M ints, shuffled order");
+    shuffled_sum("ft::make_shared", make_shared_form(), order);
+    shuffled_sum("ft::shared_ptr(new int)", new_form(), order);
+#if __cplusplus >= 201103L
+    shuffled_sum("std::make_shared", std_form(), order);
+#endif
+    return 0;
+}
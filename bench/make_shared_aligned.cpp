@@ -0,0 +1,64 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// a saxpy kernel over float arrays from make_shared<float[]>, which only guarantees the
+// alignment of float, and from make_shared_aligned<float[]>(64, n), whose kernel is told
+// the data is cache line aligned. build with -O3 -march=native to vectorize at full width.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+
+namespace
+{
+    const std::size_t element_count = 4096; // three arrays fit in L1/L2
+    const std::size_t passes = 100000;
+
+    void saxpy(float a, const float* x, float* y, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            y[i] += a * x[i];
+        }
+    }
+
+    void saxpy_aligned(float a, const float* x, float* y, std::size_t n)
+    {
+        const float* ax = static_cast<const float*>(__builtin_assume_aligned(x, 64));
+        float* ay = static_cast<float*>(__builtin_assume_aligned(y, 64));
+        for (std::size_t i = 0; i < n; i++)
+        {
+            ay[i] += a * ax[i];
+        }
+    }
+
+    template <typename TKernel>
+    void run(const char* name, const ft::shared_ptr<float[]>& x, const ft::shared_ptr<float[]>& y, TKernel kernel)
+    {
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            x[i] = static_cast<float>(i);
+            y[i] = 0;
+        }
+
+        const double start = bench::now();
+        for (std::size_t p = 0; p < passes; p++)
+        {
+            kernel(1e-6f, x.get(), y.get(), element_count);
+            bench::keep(y[p % element_count]);
+        }
+        bench::report(name, passes * element_count, bench::now() - start);
+        std::printf("%-40s %12lu %10lu\n", "  x and y address mod 64",
+                    static_cast<unsigned long>(reinterpret_cast<std::size_t>(x.get()) % 64),
+                    static_cast<unsigned long>(reinterpret_cast<std::size_t>(y.get()) % 64));
+    }
+}
+
+int main()
+{
+    bench::header("saxpy over 4096 floats, per element");
+    run("make_shared<float[]>", ft::make_shared<float[]>(element_count), ft::make_shared<float[]>(element_count), &saxpy);
+    run("make_shared_aligned<float[]>(64)", ft::make_shared_aligned<float[]>(64, element_count), ft::make_shared_aligned<float[]>(64, element_count), &saxpy_aligned);
+    return 0;
+}
@@ -0,0 +1,171 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// allocations, build, traversal and teardown of sibling nodes:
+// make_shared_batch and make_shared_group against one make_shared per object
+
+#include "bench.hpp"
+#include "count_allocations.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t node_count = 100000;
+    const std::size_t rounds = 20;
+
+    // a node of a parsed document
+    struct node
+    {
+        long value;
+        int kind;
+        int depth;
+
+        node()
+            : value(1), kind(0), depth(0) {}
+    };
+
+    struct header
+    {
+        long id;
+
+        header()
+            : id(1) {}
+    };
+
+    struct body
+    {
+        char bytes[48];
+
+        body()
+            : bytes() {}
+    };
+
+    struct trailer
+    {
+        long checksum;
+
+        trailer()
+            : checksum(1) {}
+    };
+
+    typedef std::vector<ft::shared_ptr<node> > nodes;
+
+    // the unrelated allocations a parser makes between two nodes
+    nodes build_each(std::vector<char*>& noise)
+    {
+        nodes result;
+        result.reserve(node_count);
+        for (std::size_t i = 0; i < node_count; i++)
+        {
+            result.push_back(ft::make_shared<node>());
+            noise.push_back(new char[24]);
+        }
+        return result;
+    }
+
+    nodes build_batch(std::vector<char*>& noise)
+    {
+        nodes result = ft::make_shared_batch<node>(node_count);
+        for (std::size_t i = 0; i < node_count; i++)
+        {
+            noise.push_back(new char[24]);
+        }
+        return result;
+    }
+
+    long traverse(const nodes& list)
+    {
+        long sum = 0;
+        for (std::size_t i = 0; i < list.size(); i++)
+        {
+            sum += list[i]->value + list[i]->kind;
+        }
+        return sum;
+    }
+
+    void run(const char* name, nodes (*build)(std::vector<char*>&))
+    {
+        double build_time = 0;
+        double traverse_time = 0;
+        double release_time = 0;
+        std::size_t build_allocations = 0;
+
+        for (std::size_t r = 0; r < rounds; r++)
+        {
+            std::vector<char*> noise;
+            noise.reserve(node_count);
+
+            const std::size_t before = bench::allocations().calls;
+            double start = bench::now();
+            nodes list = build(noise);
+            build_time += bench::now() - start;
+            build_allocations += bench::allocations().calls - before - node_count;
+
+            start = bench::now();
+            for (int pass = 0; pass < 10; pass++)
+            {
+                bench::keep(traverse(list));
+            }
+            traverse_time += bench::now() - start;
+
+            start = bench::now();
+            list = nodes();
+            release_time += bench::now() - start;
+
+            for (std::size_t i = 0; i < noise.size(); i++)
+            {
+                delete[] noise[i];
+            }
+        }
+
+        std::printf("%-18s allocations %8lu build %6.2f traverse %6.2f release %6.2f ns/node\n", name,
+                    static_cast<unsigned long>(build_allocations / rounds),
+                    build_time * 1e9 / (rounds * node_count),
+                    traverse_time * 1e9 / (rounds * node_count * 10),
+                    release_time * 1e9 / (rounds * node_count));
+    }
+
+    void run_group()
+    {
+        const std::size_t n = 1000000;
+
+        std::size_t before = bench::allocations().calls;
+        double start = bench::now();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            ft::shared_ptr<header> h = ft::make_shared<header>();
+            ft::shared_ptr<body> b = ft::make_shared<body>();
+            ft::shared_ptr<trailer> t = ft::make_shared<trailer>();
+            bench::keep(h->id + t->checksum + b->bytes[0]);
+        }
+        const double each = bench::now() - start;
+        const std::size_t each_allocations = bench::allocations().calls - before;
+
+        before = bench::allocations().calls;
+        start = bench::now();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            ft::shared_group<header, body, trailer> g = ft::make_shared_group<header, body, trailer>();
+            bench::keep(g.first->id + g.third->checksum + g.second->bytes[0]);
+        }
+        const double group = bench::now() - start;
+        const std::size_t group_allocations = bench::allocations().calls - before;
+
+        std::printf("%-18s allocations %8.2f %6.2f ns/group\n", "3 x make_shared", static_cast<double>(each_allocations) / n, each * 1e9 / n);
+        std::printf("%-18s allocations %8.2f %6.2f ns/group\n", "make_shared_group", static_cast<double>(group_allocations) / n, group * 1e9 / n);
+    }
+}
+
+int main()
+{
+    std::printf("%lu sibling nodes, interleaved with unrelated allocations\n", static_cast<unsigned long>(node_count));
+    run("make_shared", &build_each);
+    run("make_shared_batch", &build_batch);
+
+    std::printf("\nheader, body and trailer with one lifetime\n");
+    run_group();
+    return 0;
+}
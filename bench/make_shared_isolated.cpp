@@ -0,0 +1,84 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// reader threads copy one shared_ptr while a writer thread keeps mutating the object.
+// with make_shared the counts share a cache line with the object, with
+// make_shared_isolated they do not. needs several cores to show the difference.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <pthread.h>
+
+#include <cstddef>
+
+namespace
+{
+    const std::size_t copies_per_reader = 2000000;
+
+    struct counter
+    {
+        long hits;
+
+        counter()
+            : hits(0) {}
+    };
+
+    struct job
+    {
+        ft::shared_ptr<counter> shared;
+        int stop;
+        long writes;
+    };
+
+    void* writer(void* arg)
+    {
+        job* j = static_cast<job*>(arg);
+        counter* object = j->shared.get();
+        while (__atomic_load_n(&j->stop, __ATOMIC_ACQUIRE) == 0)
+        {
+            __atomic_store_n(&object->hits, object->hits + 1, __ATOMIC_RELAXED);
+            ++j->writes;
+        }
+        return NULL;
+    }
+
+    void* reader(void* arg)
+    {
+        const job* j = static_cast<const job*>(arg);
+        for (std::size_t i = 0; i < copies_per_reader; i++)
+        {
+            ft::shared_ptr<counter> copy = j->shared;
+            bench::keep(copy);
+        }
+        return NULL;
+    }
+
+    void run(const char* name, const ft::shared_ptr<counter>& shared, std::size_t readers)
+    {
+        job j = {shared, 0, 0};
+        pthread_t thread;
+        pthread_create(&thread, NULL, &writer, &j);
+        const double seconds = bench::run_threads(readers, &reader, &j);
+        __atomic_store_n(&j.stop, 1, __ATOMIC_RELEASE);
+        pthread_join(thread, NULL);
+
+        bench::report(name, readers * copies_per_reader, seconds);
+        std::printf("%-40s %12ld\n", "  writes meanwhile", j.writes);
+    }
+}
+
+int main()
+{
+    const std::size_t reader_counts[] = {1, 3};
+
+    for (std::size_t r = 0; r < sizeof(reader_counts) / sizeof(reader_counts[0]); r++)
+    {
+        char title[64];
+        std::sprintf(title, "1 writer, %lu reader(s), pointer copies", static_cast<unsigned long>(reader_counts[r]));
+        bench::header(title);
+        run("make_shared", ft::make_shared<counter>(), reader_counts[r]);
+        run("make_shared_isolated", ft::make_shared_isolated<counter>(), reader_counts[r]);
+    }
+    return 0;
+}
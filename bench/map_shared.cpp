@@ -0,0 +1,141 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// startup of a 256 MiB read-only table: map_shared against reading the file into a
+// make_shared array. startup is the time until the first element can be read, resident
+// is the growth of the resident set at that point; a full scan follows.
+// the file is written first, so both read from the page cache.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+
+namespace
+{
+    const char* const path = "/tmp/smart_ptr_map_shared.bin";
+    const std::size_t element_count = (256UL << 20) / sizeof(long);
+
+    // bytes
+    std::size_t resident() throw()
+    {
+        unsigned long size = 0;
+        unsigned long pages = 0;
+        std::FILE* f = std::fopen("/proc/self/statm", "r");
+        if (f == NULL)
+        {
+            return 0;
+        }
+        if (std::fscanf(f, "%lu %lu", &size, &pages) != 2)
+        {
+            pages = 0;
+        }
+        std::fclose(f);
+        return pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    bool write_file()
+    {
+        std::FILE* f = std::fopen(path, "wb");
+        if (f == NULL)
+        {
+            return false;
+        }
+        long block[4096];
+        for (std::size_t i = 0; i < element_count; i += 4096)
+        {
+            for (std::size_t j = 0; j < 4096; j++)
+            {
+                block[j] = static_cast<long>(i + j);
+            }
+            std::fwrite(block, sizeof(long), 4096, f);
+        }
+        return std::fclose(f) == 0;
+    }
+
+    ft::shared_ptr<const long[]> read_file()
+    {
+        ft::shared_ptr<long[]> table = ft::make_shared<long[]>(element_count);
+        std::FILE* f = std::fopen(path, "rb");
+        if (f == NULL)
+        {
+            return ft::shared_ptr<const long[]>();
+        }
+        const std::size_t got = std::fread(table.get(), sizeof(long), element_count, f);
+        std::fclose(f);
+        return got == element_count ? ft::shared_ptr<const long[]>(table) : ft::shared_ptr<const long[]>();
+    }
+
+    void report_startup(const char* name, double seconds, std::size_t before)
+    {
+        const std::size_t after = resident();
+        std::printf("%-40s %12s %10.2f us\n", name, "", seconds * 1e6);
+        std::printf("%-40s %12s %10.2f MiB\n", "  resident", "", static_cast<double>(after > before ? after - before : 0) / (1 << 20));
+    }
+
+    void scan(const char* name, const ft::shared_ptr<const long[]>& table)
+    {
+        long sum = 0;
+        const double start = bench::now();
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            sum += table[i];
+        }
+        bench::report(name, element_count, bench::now() - start);
+        bench::keep(sum);
+    }
+
+    template <typename TOpen>
+    void run(const char* name, TOpen open)
+    {
+        char label[64];
+        const std::size_t before = resident();
+        const double start = bench::now();
+        ft::shared_ptr<const long[]> table = open();
+        if (!table)
+        {
+            std::printf("%-40s failed\n", name);
+            return;
+        }
+        bench::keep(table[0]);
+        std::sprintf(label, "%s, startup", name);
+        report_startup(label, bench::now() - start, before);
+
+        std::sprintf(label, "%s, scan", name);
+        scan(label, table);
+    }
+
+    struct open_mapped
+    {
+        ft::shared_ptr<const long[]> operator()() const
+        {
+            return ft::map_shared<long[]>(path, 0, element_count * sizeof(long));
+        }
+    };
+
+    struct open_read
+    {
+        ft::shared_ptr<const long[]> operator()() const
+        {
+            return read_file();
+        }
+    };
+}
+
+int main()
+{
+    if (!write_file())
+    {
+        std::printf("can not write %s\n", path);
+        return 1;
+    }
+
+    bench::header("256 MiB table of long");
+    run("map_shared", open_mapped());
+    run("make_shared and fread", open_read());
+    std::remove(path);
+    return 0;
+}
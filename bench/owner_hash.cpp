@@ -0,0 +1,149 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// lookups of shared_ptr keys in a hash table with a power of two bucket count, keyed by
+// owner_hash, by the unmixed control block address and by the object address as
+// std::hash does. with -std=c++11 or later, std::unordered_set is measured as well.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <functional>
+#include <unordered_set>
+#endif
+
+namespace
+{
+    const std::size_t key_count = 1 << 16;
+    const std::size_t lookups = 10000000;
+
+    struct node
+    {
+        long value;
+    };
+
+    typedef ft::shared_ptr<node> key_type;
+
+    struct owner_hasher
+    {
+        std::size_t operator()(const key_type& p) const { return p.owner_hash(); }
+    };
+
+    struct block_address
+    {
+        std::size_t operator()(const key_type& p) const { return reinterpret_cast<std::size_t>(p.get_counted()); }
+    };
+
+    struct object_address
+    {
+        std::size_t operator()(const key_type& p) const { return reinterpret_cast<std::size_t>(p.get()); }
+    };
+
+    // separate chaining, buckets selected by the low bits of the hash
+    template <typename THash>
+    class table
+    {
+    private:
+        std::vector<std::vector<key_type> > buckets;
+        THash hasher;
+
+    public:
+        explicit table(std::size_t bucket_count)
+            : buckets(bucket_count), hasher() {}
+
+        void insert(const key_type& key)
+        {
+            this->buckets[this->hasher(key) & (this->buckets.size() - 1)].push_back(key);
+        }
+
+        bool contains(const key_type& key) const
+        {
+            const std::vector<key_type>& bucket = this->buckets[this->hasher(key) & (this->buckets.size() - 1)];
+            for (std::size_t i = 0; i < bucket.size(); i++)
+            {
+                if (bucket[i].owner_equal(key))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::size_t used_buckets() const
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < this->buckets.size(); i++)
+            {
+                n += this->buckets[i].empty() ? 0 : 1;
+            }
+            return n;
+        }
+    };
+
+    template <typename TSet>
+    void run(const char* name, const TSet& set, const std::vector<key_type>& keys)
+    {
+        std::size_t found = 0;
+        unsigned seed = 1;
+        const double start = bench::now();
+        for (std::size_t i = 0; i < lookups; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            found += set.count(keys[(seed >> 8) % keys.size()]);
+        }
+        bench::report(name, lookups, bench::now() - start);
+        bench::keep(found);
+    }
+
+    template <typename THash>
+    struct counted_table : table<THash>
+    {
+        explicit counted_table(std::size_t bucket_count)
+            : table<THash>(bucket_count) {}
+
+        std::size_t count(const key_type& key) const { return this->contains(key) ? 1 : 0; }
+    };
+
+    template <typename THash>
+    void run_table(const char* name, const std::vector<key_type>& keys)
+    {
+        counted_table<THash> set(key_count);
+        for (std::size_t i = 0; i < keys.size(); i++)
+        {
+            set.insert(keys[i]);
+        }
+        run(name, set, keys);
+        std::printf("%-40s %12lu of %lu\n", "  buckets used", static_cast<unsigned long>(set.used_buckets()), static_cast<unsigned long>(key_count));
+    }
+}
+
+int main()
+{
+    std::vector<key_type> keys;
+    for (std::size_t i = 0; i < key_count; i++)
+    {
+        keys.push_back(ft::make_shared<node>());
+    }
+
+    bench::header("64Ki keys, 64Ki buckets, lookups");
+    run_table<owner_hasher>("owner_hash", keys);
+    run_table<block_address>("control block address", keys);
+    run_table<object_address>("object address", keys);
+
+#if __cplusplus >= 201103L
+    bench::header("std::unordered_set, lookups");
+    {
+        std::unordered_set<key_type, ft::owner_hash, ft::owner_equal> set(keys.begin(), keys.end());
+        run("ft::owner_hash", set, keys);
+    }
+    {
+        std::unordered_set<key_type> set(keys.begin(), keys.end());
+        run("std::hash", set, keys);
+    }
+#endif
+    return 0;
+}
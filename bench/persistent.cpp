@@ -0,0 +1,127 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// snapshot and update cost of persistent_vector and persistent_map
+// against copying std::vector and std::map
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace
+{
+    const std::size_t element_count = 100000;
+    const std::size_t requests = 1000;
+    const std::size_t updates_per_request = 10;
+    const std::size_t reads = 10000000;
+
+    std::size_t key_of(std::size_t request, std::size_t update) throw()
+    {
+        return (request * 7919 + update * 104729) % element_count;
+    }
+
+    // each request snapshots the shared state and edits its snapshot
+    template <typename TContainer, typename TUpdate>
+    void requests_on(const char* name, const TContainer& state, TUpdate update)
+    {
+        double snapshot = 0;
+        double edit = 0;
+        for (std::size_t r = 0; r < requests; r++)
+        {
+            double start = bench::now();
+            TContainer copy(state);
+            snapshot += bench::now() - start;
+
+            start = bench::now();
+            for (std::size_t u = 0; u < updates_per_request; u++)
+            {
+                update(copy, key_of(r, u), static_cast<long>(r));
+            }
+            edit += bench::now() - start;
+        }
+        std::printf("%-28s snapshot %12.0f update %8.0f ns\n", name, snapshot * 1e9 / requests, edit * 1e9 / (requests * updates_per_request));
+    }
+
+    struct vector_update
+    {
+        void operator()(std::vector<long>& v, std::size_t i, long value) const { v[i] = value; }
+        void operator()(ft::persistent_vector<long>& v, std::size_t i, long value) const { v.set(i, value); }
+    };
+
+    struct map_update
+    {
+        void operator()(std::map<long, long>& m, std::size_t k, long value) const { m[static_cast<long>(k)] = value; }
+        void operator()(ft::persistent_map<long, long>& m, std::size_t k, long value) const { m.set(static_cast<long>(k), value); }
+    };
+
+    template <typename TContainer>
+    long read_vector(const TContainer& v)
+    {
+        long sum = 0;
+        for (std::size_t i = 0; i < reads; i++)
+        {
+            sum += v[(i * 7919) % element_count];
+        }
+        return sum;
+    }
+
+    long find(const std::map<long, long>& m, long k)
+    {
+        return m.find(k)->second;
+    }
+
+    long find(const ft::persistent_map<long, long>& m, long k)
+    {
+        return *m.find(k);
+    }
+
+    template <typename TContainer>
+    long read_map(const TContainer& m)
+    {
+        long sum = 0;
+        for (std::size_t i = 0; i < reads; i++)
+        {
+            sum += find(m, static_cast<long>((i * 7919) % element_count));
+        }
+        return sum;
+    }
+
+    template <typename TContainer, typename TRead>
+    void reads_on(const char* name, const TContainer& c, TRead read)
+    {
+        const double start = bench::now();
+        bench::keep(read(c));
+        bench::report(name, reads, bench::now() - start);
+    }
+}
+
+int main()
+{
+    std::vector<long> vector(element_count);
+    ft::persistent_vector<long> pvector;
+    std::map<long, long> map;
+    ft::persistent_map<long, long> pmap;
+    for (std::size_t i = 0; i < element_count; i++)
+    {
+        vector[i] = static_cast<long>(i);
+        pvector.push_back(static_cast<long>(i));
+        map[static_cast<long>(i)] = static_cast<long>(i);
+        pmap.set(static_cast<long>(i), static_cast<long>(i));
+    }
+
+    std::printf("%lu elements, %lu updates per snapshot\n", static_cast<unsigned long>(element_count), static_cast<unsigned long>(updates_per_request));
+    requests_on("std::vector", vector, vector_update());
+    requests_on("ft::persistent_vector", pvector, vector_update());
+    requests_on("std::map", map, map_update());
+    requests_on("ft::persistent_map", pmap, map_update());
+
+    bench::header("reads");
+    reads_on("std::vector", vector, &read_vector<std::vector<long> >);
+    reads_on("ft::persistent_vector", pvector, &read_vector<ft::persistent_vector<long> >);
+    reads_on("std::map", map, &read_map<std::map<long, long> >);
+    reads_on("ft::persistent_map", pmap, &read_map<ft::persistent_map<long, long> >);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// allocate_shared with std::pmr::polymorphic_allocator over an unsynchronized pool and
+// over a monotonic buffer, against make_shared. needs -std=c++17 or later.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <memory_resource>
+
+namespace
+{
+    const std::size_t rounds = 20000;
+    const std::size_t objects_per_round = 256;
+
+    struct node
+    {
+        long value;
+        double weight;
+
+        node(long value, double weight)
+            : value(value), weight(weight) {}
+    };
+
+    // fills a window of objects, reads them and drops them, once per round
+    template <typename TMake, typename TEndRound>
+    void run(const char* name, TMake make, TEndRound end_round)
+    {
+        std::vector<ft::shared_ptr<node> > window;
+        window.reserve(objects_per_round);
+        long sum = 0;
+
+        const double start = bench::now();
+        for (std::size_t r = 0; r < rounds; r++)
+        {
+            for (std::size_t i = 0; i < objects_per_round; i++)
+            {
+                window.push_back(make(static_cast<long>(i)));
+            }
+            for (std::size_t i = 0; i < window.size(); i++)
+            {
+                sum += window[i]->value;
+            }
+            window.clear();
+            end_round();
+        }
+        bench::report(name, rounds * objects_per_round, bench::now() - start);
+        bench::keep(sum);
+    }
+}
+
+int main()
+{
+    char title[64];
+    std::sprintf(title, "%lu rounds of %lu objects", static_cast<unsigned long>(rounds), static_cast<unsigned long>(objects_per_round));
+    bench::header(title);
+
+    std::pmr::unsynchronized_pool_resource pool;
+    run(
+        "allocate_shared, pool resource",
+        [&pool](long i) { return ft::allocate_shared<node>(std::pmr::polymorphic_allocator<node>(&pool), i, 1.0); },
+        [] {});
+
+    std::pmr::monotonic_buffer_resource buffer;
+    run(
+        "allocate_shared, monotonic buffer",
+        [&buffer](long i) { return ft::allocate_shared<node>(std::pmr::polymorphic_allocator<node>(&buffer), i, 1.0); },
+        [&buffer] { buffer.release(); });
+
+    run(
+        "make_shared",
+        [](long i) { return ft::make_shared<node>(i, 1.0); },
+        [] {});
+    return 0;
+}
+#else
+int main()
+{
+    std::printf("std::pmr needs -std=c++17 or later\n");
+    return 0;
+}
+#endif
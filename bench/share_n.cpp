@@ -0,0 +1,71 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// fan-out of one shared_ptr to 1000 subscribers and back:
+// share_n and release_all against one copy and one reset per subscriber
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t fan_out = 1000;
+    const std::size_t rounds = 10000;
+
+    struct message
+    {
+        char bytes[64];
+    };
+
+    typedef std::vector<ft::shared_ptr<message> > subscribers;
+}
+
+int main()
+{
+    const ft::shared_ptr<message> source = ft::make_shared<message>();
+    subscribers slots(fan_out);
+
+    double share = 0;
+    double release = 0;
+    for (std::size_t r = 0; r < rounds; r++)
+    {
+        double start = bench::now();
+        for (std::size_t i = 0; i < fan_out; i++)
+        {
+            slots[i] = source;
+        }
+        share += bench::now() - start;
+
+        start = bench::now();
+        for (std::size_t i = 0; i < fan_out; i++)
+        {
+            slots[i].reset();
+        }
+        release += bench::now() - start;
+    }
+
+    double share_bulk = 0;
+    double release_bulk = 0;
+    for (std::size_t r = 0; r < rounds; r++)
+    {
+        double start = bench::now();
+        source.share_n(slots.begin(), fan_out);
+        share_bulk += bench::now() - start;
+
+        start = bench::now();
+        ft::release_all(slots.begin(), slots.end());
+        release_bulk += bench::now() - start;
+    }
+
+    char title[64];
+    std::sprintf(title, "1 -> %lu, per subscriber", static_cast<unsigned long>(fan_out));
+    bench::header(title);
+    bench::report("copy each", rounds * fan_out, share);
+    bench::report("share_n", rounds * fan_out, share_bulk);
+    bench::report("reset each", rounds * fan_out, release);
+    bench::report("release_all", rounds * fan_out, release_bulk);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// throughput of a read, frame, forward pipeline on buffer_chain against one that copies
+// every record into its own std::vector at each stage boundary
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace
+{
+    const std::size_t read_size = 64 << 10;
+    const std::size_t total_bytes = static_cast<std::size_t>(1) << 30;
+    const std::size_t iovec_max = 64;
+
+    // records of 64 to 1563 bytes, cut without regard to read boundaries
+    std::size_t record_size(std::size_t i) throw()
+    {
+        return 64 + (i * 7919) % 1500;
+    }
+
+    void fill(unsigned char* p, std::size_t n, std::size_t seed) throw()
+    {
+        std::memset(p, static_cast<int>(seed), n);
+    }
+
+    // stands for writev(), touches the first byte of every vector
+    std::size_t sink(const struct iovec* iov, std::size_t count) throw()
+    {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            sum += iov[i].iov_len + *static_cast<const unsigned char*>(iov[i].iov_base);
+        }
+        return sum;
+    }
+
+    double zero_copy()
+    {
+        const double start = bench::now();
+        ft::buffer_chain input;
+        ft::buffer_chain output;
+        std::size_t record = 0;
+        std::size_t written = 0;
+        for (std::size_t read = 0; read < total_bytes; read += read_size)
+        {
+            ft::shared_buffer chunk(read_size);
+            fill(chunk.mutable_data(), read_size, read);
+            input.append(chunk);
+
+            // frame records off the input and forward them unchanged
+            while (input.size() >= record_size(record))
+            {
+                output.append(input.split(record_size(record++)));
+            }
+
+            while (output.buffer_count() >= iovec_max)
+            {
+                struct iovec iov[iovec_max];
+                const std::size_t count = output.to_iovec(iov, iovec_max);
+                std::size_t bytes = 0;
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    bytes += iov[i].iov_len;
+                }
+                written += sink(iov, count);
+                output.consume(bytes);
+            }
+        }
+        bench::keep(written);
+        return bench::now() - start;
+    }
+
+    double copying()
+    {
+        const double start = bench::now();
+        std::deque<unsigned char> input;
+        std::deque<std::vector<unsigned char> > output;
+        std::vector<unsigned char> chunk(read_size);
+        std::size_t record = 0;
+        std::size_t written = 0;
+        for (std::size_t read = 0; read < total_bytes; read += read_size)
+        {
+            fill(&chunk[0], read_size, read);
+            input.insert(input.end(), chunk.begin(), chunk.end());
+
+            while (input.size() >= record_size(record))
+            {
+                const std::size_t n = record_size(record++);
+                output.push_back(std::vector<unsigned char>(input.begin(), input.begin() + n));
+                input.erase(input.begin(), input.begin() + n);
+            }
+
+            while (output.size() >= iovec_max)
+            {
+                struct iovec iov[iovec_max];
+                for (std::size_t i = 0; i < iovec_max; i++)
+                {
+                    iov[i].iov_base = &output[i][0];
+                    iov[i].iov_len = output[i].size();
+                }
+                written += sink(iov, iovec_max);
+                output.erase(output.begin(), output.begin() + iovec_max);
+            }
+        }
+        bench::keep(written);
+        return bench::now() - start;
+    }
+
+    void report(const char* name, double seconds)
+    {
+        std::printf("%-24s %8.0f MiB/s\n", name, static_cast<double>(total_bytes) / (1 << 20) / seconds);
+    }
+}
+
+int main()
+{
+    std::printf("%lu MiB read in %lu KiB chunks\n", static_cast<unsigned long>(total_bytes >> 20), static_cast<unsigned long>(read_size >> 10));
+    report("buffer_chain", zero_copy());
+    report("copy per stage", copying());
+    return 0;
+}
@@ -0,0 +1,154 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// callbacks that keep their session alive: each event queues a callback holding a
+// strong reference from shared_from_this(), from weak_from_this().lock() or from a
+// copy of a shared_ptr the caller holds, and the queue is drained in batches.
+// then new owners taking over objects whose owner expired, on several threads.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <memory>
+#endif
+
+namespace
+{
+    const std::size_t events = 10000000;
+    const std::size_t batch = 64;
+    const std::size_t takeovers_per_thread = 1000000;
+
+    template <typename TPtr>
+    struct callback
+    {
+        TPtr session;
+
+        explicit callback(const TPtr& session)
+            : session(session) {}
+
+        void operator()() const
+        {
+            ++this->session->handled;
+        }
+    };
+
+    struct session : ft::enable_shared_from_this<session>
+    {
+        long handled;
+
+        session()
+            : handled(0) {}
+    };
+
+    struct no_delete
+    {
+        void operator()(session*) const throw() {}
+    };
+
+    struct from_this
+    {
+        ft::shared_ptr<session> operator()(session& s, const ft::shared_ptr<session>&) const
+        {
+            return s.shared_from_this();
+        }
+    };
+
+    struct from_weak
+    {
+        ft::shared_ptr<session> operator()(session& s, const ft::shared_ptr<session>&) const
+        {
+            return s.weak_from_this().lock();
+        }
+    };
+
+    struct from_copy
+    {
+        ft::shared_ptr<session> operator()(session&, const ft::shared_ptr<session>& held) const
+        {
+            return held;
+        }
+    };
+
+    template <typename TPtr, typename TSession, typename TRef>
+    void dispatch(const char* name, const TPtr& held, TRef ref)
+    {
+        std::vector<callback<TPtr> > queue;
+        queue.reserve(batch);
+        TSession& s = *held;
+
+        const double start = bench::now();
+        for (std::size_t i = 0; i < events; i++)
+        {
+            queue.push_back(callback<TPtr>(ref(s, held)));
+            if (queue.size() == batch)
+            {
+                for (std::size_t j = 0; j < queue.size(); j++)
+                {
+                    queue[j]();
+                }
+                queue.clear();
+            }
+        }
+        bench::report(name, events, bench::now() - start);
+        bench::keep(s.handled);
+    }
+
+#if __cplusplus >= 201103L
+    struct std_session : std::enable_shared_from_this<std_session>
+    {
+        long handled;
+
+        std_session()
+            : handled(0) {}
+    };
+
+    struct from_std_this
+    {
+        std::shared_ptr<std_session> operator()(std_session& s, const std::shared_ptr<std_session>&) const
+        {
+            return s.shared_from_this();
+        }
+    };
+#endif
+
+    // every owner of an object of this thread expires before the next one takes over
+    void* take_over(void*)
+    {
+        session objects[8];
+        for (std::size_t i = 0; i < takeovers_per_thread; i++)
+        {
+            session& s = objects[i % 8];
+            ft::shared_ptr<session> owner(&s, no_delete());
+            bench::keep(s.shared_from_this());
+        }
+        return NULL;
+    }
+}
+
+int main()
+{
+    bench::header("callbacks holding their session");
+    ft::shared_ptr<session> held = ft::make_shared<session>();
+    dispatch<ft::shared_ptr<session>, session>("shared_from_this()", held, from_this());
+    dispatch<ft::shared_ptr<session>, session>("weak_from_this().lock()", held, from_weak());
+    dispatch<ft::shared_ptr<session>, session>("copy of a held shared_ptr", held, from_copy());
+#if __cplusplus >= 201103L
+    std::shared_ptr<std_session> std_held = std::make_shared<std_session>();
+    dispatch<std::shared_ptr<std_session>, std_session>("std::shared_from_this()", std_held, from_std_this());
+#endif
+
+    bench::header("new owner after the previous one expired");
+    const std::size_t thread_counts[] = {1, 4};
+    for (std::size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        char label[64];
+        std::sprintf(label, "%lu thread(s)", static_cast<unsigned long>(thread_counts[t]));
+        const double seconds = bench::run_threads(thread_counts[t], &take_over, NULL);
+        bench::report(label, thread_counts[t] * takeovers_per_thread, seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// shared_pool acquire/release churn against make_shared churn
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t ops_per_thread = 1000000;
+    const std::size_t in_flight = 16;
+
+    // a buffer whose construction costs an allocation
+    struct buffer
+    {
+        std::vector<char> bytes;
+
+        buffer()
+            : bytes()
+        {
+            this->bytes.reserve(4096);
+        }
+    };
+
+    struct clear_buffer
+    {
+        void operator()(buffer& b) const throw()
+        {
+            b.bytes.clear();
+        }
+    };
+
+    typedef ft::shared_pool<buffer, clear_buffer> pool_type;
+
+    struct from_pool
+    {
+        pool_type* pool;
+
+        ft::shared_ptr<buffer> operator()() const
+        {
+            return this->pool->acquire();
+        }
+    };
+
+    struct from_make_shared
+    {
+        ft::shared_ptr<buffer> operator()() const
+        {
+            return ft::make_shared<buffer>();
+        }
+    };
+
+    // keeps a window of live buffers and replaces one per iteration
+    template <typename TSource>
+    void* churn(void* arg)
+    {
+        const TSource& source = *static_cast<const TSource*>(arg);
+        std::vector<ft::shared_ptr<buffer> > window(in_flight);
+        for (std::size_t i = 0; i < ops_per_thread; i++)
+        {
+            ft::shared_ptr<buffer>& slot = window[i % in_flight];
+            slot = source();
+            slot->bytes.push_back(static_cast<char>(i));
+        }
+        return NULL;
+    }
+
+    template <typename TSource>
+    void run(const char* name, TSource source, std::size_t threads)
+    {
+        const double seconds = bench::run_threads(threads, &churn<TSource>, &source);
+        bench::report(name, threads * ops_per_thread, seconds);
+    }
+}
+
+int main()
+{
+    const std::size_t thread_counts[] = {1, 4};
+
+    for (std::size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        const std::size_t threads = thread_counts[t];
+        char title[64];
+        std::sprintf(title, "%lu thread(s), %lu buffers in flight each", static_cast<unsigned long>(threads), static_cast<unsigned long>(in_flight));
+        bench::header(title);
+
+        pool_type pool(2 * in_flight);
+        from_pool pooled = {&pool};
+        run("shared_pool::acquire", pooled, threads);
+        run("make_shared", from_make_shared(), threads);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// emit latency of a signal, alone and while another thread connects and disconnects
+// slots without pause. the longest emit shows whether writers block emitters;
+// it needs two cores, on one the writer thread takes time slices from the emitter.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    const std::size_t slot_calls = 10000000; // per case, split into emits
+
+    struct counter
+    {
+        long n;
+
+        counter()
+            : n(0) {}
+
+        void operator()(long value)
+        {
+            this->n += value;
+        }
+    };
+
+    typedef ft::signal<long> signal_type;
+
+    struct churn_job
+    {
+        signal_type* signal;
+        int stop;
+        std::size_t changes;
+    };
+
+    void* churn(void* arg)
+    {
+        churn_job* job = static_cast<churn_job*>(arg);
+        while (__atomic_load_n(&job->stop, __ATOMIC_ACQUIRE) == 0)
+        {
+            ft::shared_ptr<counter> slot = ft::make_shared<counter>();
+            job->signal->connect(slot);
+            job->signal->disconnect(slot);
+            job->changes += 2;
+        }
+        return NULL;
+    }
+
+    void emit_all(const char* name, const signal_type& signal, std::size_t emits)
+    {
+        double longest = 0;
+        const double start = bench::now();
+        for (std::size_t i = 0; i < emits; i++)
+        {
+            const double step = bench::now();
+            signal.emit(1);
+            const double pause = bench::now() - step;
+            longest = pause > longest ? pause : longest;
+        }
+        bench::report(name, emits, bench::now() - start);
+        std::printf("%-40s %12s %10.2f us\n", "  longest emit", "", longest * 1e6);
+    }
+
+    void run(std::size_t subscribers)
+    {
+        signal_type signal;
+        std::vector<ft::shared_ptr<counter> > slots;
+        for (std::size_t i = 0; i < subscribers; i++)
+        {
+            slots.push_back(ft::make_shared<counter>());
+            signal.connect(slots.back());
+        }
+
+        const std::size_t emits = slot_calls / subscribers;
+        emit_all("emit", signal, emits);
+
+        churn_job job = {&signal, 0, 0};
+        pthread_t writer;
+        pthread_create(&writer, NULL, &churn, &job);
+        emit_all("emit, connect/disconnect churn", signal, emits);
+        __atomic_store_n(&job.stop, 1, __ATOMIC_RELEASE);
+        pthread_join(writer, NULL);
+        std::printf("%-40s %12lu\n", "  slot changes meanwhile", static_cast<unsigned long>(job.changes));
+
+        bench::keep(slots.front()->n);
+    }
+}
+
+int main()
+{
+    const std::size_t subscriber_counts[] = {10, 1000, 10000};
+
+    for (std::size_t s = 0; s < sizeof(subscriber_counts) / sizeof(subscriber_counts[0]); s++)
+    {
+        char title[64];
+        std::sprintf(title, "%lu subscribers", static_cast<unsigned long>(subscriber_counts[s]));
+        bench::header(title);
+        run(subscriber_counts[s]);
+    }
+    return 0;
+}
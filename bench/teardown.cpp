@@ -0,0 +1,94 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// teardown of singly linked lists of shared_ptr.
+// build twice to compare: as is, recursive release only runs the list that fits the stack;
+// with -DSMART_PTR_ITERATIVE_RELEASE every size runs, and a budgeted teardown
+// reports its longest pause.
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+
+namespace
+{
+    struct node
+    {
+        ft::shared_ptr<node> next;
+        long value;
+    };
+
+    ft::shared_ptr<node> list(std::size_t n)
+    {
+        ft::shared_ptr<node> head;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            ft::shared_ptr<node> x = ft::make_shared<node>();
+            x->next = head;
+            x->value = static_cast<long>(i);
+            head = x;
+        }
+        return head;
+    }
+
+    void teardown(std::size_t n)
+    {
+        ft::shared_ptr<node> head = list(n);
+        const double start = bench::now();
+        head.reset();
+        bench::report("reset()", n, bench::now() - start);
+    }
+
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+    // releases at most `budget` nodes per step, as a server would between two requests
+    void budgeted_teardown(std::size_t n, std::size_t budget)
+    {
+        ft::shared_ptr<node> head = list(n);
+        const double start = bench::now();
+        double longest = 0;
+        std::size_t steps = 1;
+        {
+            ft::release_budget limit(budget);
+            double step = bench::now();
+            head.reset();
+            longest = bench::now() - step;
+            while (ft::pending_releases() != 0)
+            {
+                step = bench::now();
+                ft::drain_releases(budget);
+                const double pause = bench::now() - step;
+                longest = pause > longest ? pause : longest;
+                ++steps;
+            }
+        }
+        char name[64];
+        std::sprintf(name, "budget %lu, %lu steps", static_cast<unsigned long>(budget), static_cast<unsigned long>(steps));
+        bench::report(name, n, bench::now() - start);
+        std::printf("%-40s %12s %10.0f us\n", "  longest pause", "", longest * 1e6);
+    }
+#endif
+}
+
+int main()
+{
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+    const std::size_t sizes[] = {100000, 1000000, 10000000};
+    const char* mode = "iterative release";
+#else
+    const std::size_t sizes[] = {100000};
+    const char* mode = "recursive release, larger lists overflow the stack";
+#endif
+
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        char title[128];
+        std::sprintf(title, "%lu nodes, %s", static_cast<unsigned long>(sizes[i]), mode);
+        bench::header(title);
+        teardown(sizes[i]);
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        budgeted_teardown(sizes[i], 10000);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// hit and miss throughput of weak_cache against a mutex guarded map of weak_ptr
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace
+{
+    const std::size_t key_count = 1024;
+    const std::size_t ops_per_thread = 1000000;
+
+    struct value
+    {
+        long key;
+        char payload[56];
+
+        explicit value(long key)
+            : key(key), payload() {}
+    };
+
+    // the pattern weak_cache replaces
+    class locked_map
+    {
+    private:
+        ft::_internal::mutex mutex;
+        std::map<long, ft::weak_ptr<value> > map;
+
+    public:
+        ft::shared_ptr<value> get(long key)
+        {
+            ft::_internal::mutex_guard guard(this->mutex);
+            ft::weak_ptr<value>& slot = this->map[key];
+            ft::shared_ptr<value> hit = slot.lock();
+            if (!hit)
+            {
+                hit = ft::make_shared<value>(key);
+                slot = hit;
+            }
+            return hit;
+        }
+    };
+
+    template <typename TCache>
+    struct job
+    {
+        TCache* cache;
+        unsigned next_seed;
+    };
+
+    template <typename TCache>
+    void* lookups(void* arg)
+    {
+        job<TCache>* j = static_cast<job<TCache>*>(arg);
+        unsigned seed = __sync_fetch_and_add(&j->next_seed, 7919u);
+        for (std::size_t i = 0; i < ops_per_thread; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            ft::shared_ptr<value> v = j->cache->get(static_cast<long>((seed >> 8) % key_count));
+            bench::keep(v->key);
+        }
+        return NULL;
+    }
+
+    template <typename TCache>
+    void run(const char* name, TCache& cache, std::size_t threads)
+    {
+        job<TCache> j = {&cache, 1};
+        const double seconds = bench::run_threads(threads, &lookups<TCache>, &j);
+        bench::report(name, threads * ops_per_thread, seconds);
+    }
+}
+
+int main()
+{
+    const std::size_t thread_counts[] = {1, 4};
+
+    for (std::size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        const std::size_t threads = thread_counts[t];
+        char title[64];
+        std::sprintf(title, "%lu thread(s)", static_cast<unsigned long>(threads));
+        bench::header(title);
+
+        // hits: every key is held for the whole run
+        {
+            ft::weak_cache<long, value> cache;
+            locked_map baseline;
+            std::vector<ft::shared_ptr<value> > held;
+            for (std::size_t k = 0; k < key_count; k++)
+            {
+                held.push_back(cache.get(static_cast<long>(k)));
+                held.push_back(baseline.get(static_cast<long>(k)));
+            }
+            run("hit weak_cache", cache, threads);
+            run("hit locked map", baseline, threads);
+        }
+
+        // misses: nothing is held, each lookup builds and evicts
+        {
+            ft::weak_cache<long, value> cache;
+            locked_map baseline;
+            run("miss weak_cache", cache, threads);
+            run("miss locked map", baseline, threads);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// weak_ptr::lock() on a live and on an expired object, against the same failure
+// reported by the throwing shared_ptr(weak_ptr) constructor and caught
+
+#include "bench.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+
+namespace
+{
+    const std::size_t locks = 10000000;
+    const std::size_t throws = 1000000;
+
+    void lock_loop(const char* name, const ft::weak_ptr<int>& weak)
+    {
+        std::size_t hits = 0;
+        const double start = bench::now();
+        for (std::size_t i = 0; i < locks; i++)
+        {
+            hits += weak.lock() ? 1 : 0;
+        }
+        bench::report(name, locks, bench::now() - start);
+        bench::keep(hits);
+    }
+}
+
+int main()
+{
+    ft::shared_ptr<int> live = ft::make_shared<int>(1);
+    ft::weak_ptr<int> to_live = live;
+    ft::weak_ptr<int> expired = ft::make_shared<int>(2);
+
+    bench::header("weak_ptr to shared_ptr");
+    lock_loop("lock(), live", to_live);
+    lock_loop("lock(), expired", expired);
+
+    std::size_t failures = 0;
+    const double start = bench::now();
+    for (std::size_t i = 0; i < throws; i++)
+    {
+        try
+        {
+            ft::shared_ptr<int> p(expired);
+            bench::keep(p);
+        }
+        catch (const ft::bad_weak_ptr&)
+        {
+            ++failures;
+        }
+    }
+    bench::report("shared_ptr(weak_ptr), expired, catch", throws, bench::now() - start);
+    bench::keep(failures);
+    return 0;
+}
@@ -0,0 +1,292 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_ptr_element.hpp"
+#include "_ref_counted.hpp"
+#include "bad_weak_ptr.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+#include "weak_ptr.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace ft
+{
+    template <typename T>
+    class compact_weak_ptr;
+
+    // single word shared_ptr for blocks created by make_shared<T>.
+    // the object address is derived from the block, so aliasing is not allowed:
+    // converting any other shared_ptr throws bad_weak_ptr instead of losing its ownership.
+    template <typename T>
+    class compact_shared_ptr
+    {
+    public:
+        typedef T element_type;
+        typedef _internal::inplace_counted<T, std::allocator<T> > inplace_type;
+        typedef typename inplace_type::type counted_type;
+
+    private:
+        template <typename U>
+        friend class compact_weak_ptr;
+
+    private:
+        counted_type* ptr;
+
+        // adopts a strong reference already taken on `ptr`
+        compact_shared_ptr(_internal::adopt_tag, counted_type* ptr) throw()
+            : ptr(ptr) {}
+
+    public:
+        compact_shared_ptr() throw()
+            : ptr(NULL) {}
+
+        // throws bad_weak_ptr if `that` was not created by make_shared<T> or is aliased
+        explicit compact_shared_ptr(const shared_ptr<T>& that)
+            : ptr(dynamic_cast<counted_type*>(that.get_counted()))
+        {
+            if (that.get_counted() != NULL && (this->ptr == NULL || inplace_type::get_pointer(this->ptr) != that.get()))
+            {
+                SMART_PTR_THROW(bad_weak_ptr());
+            }
+
+            if (this->ptr != NULL)
+            {
+                this->ptr->add_ref_copy();
+            }
+        }
+
+        compact_shared_ptr(const compact_shared_ptr& that) throw()
+            : ptr(that.ptr)
+        {
+            if (this->ptr != NULL)
+            {
+                this->ptr->add_ref_copy();
+            }
+        }
+
+        ~compact_shared_ptr() throw()
+        {
+            // Compile-time test
+            static_cast<void>(sizeof(char[_internal::is_array<T>::value ? -1 : 1]));
+
+            if (this->ptr != NULL)
+            {
+                this->ptr->release();
+            }
+        }
+
+        compact_shared_ptr& operator=(const compact_shared_ptr& that) throw()
+        {
+            compact_shared_ptr(that).swap(*this);
+            return *this;
+        }
+
+        compact_shared_ptr& operator=(const shared_ptr<T>& that)
+        {
+            compact_shared_ptr(that).swap(*this);
+            return *this;
+        }
+
+        operator shared_ptr<T>() const throw()
+        {
+            if (this->ptr == NULL)
+            {
+                return shared_ptr<T>();
+            }
+            this->ptr->add_ref_copy();
+            return shared_ptr<T>(_internal::adopt_tag(), inplace_type::get_pointer(this->ptr), this->ptr);
+        }
+
+        void reset() throw()
+        {
+            compact_shared_ptr().swap(*this);
+        }
+
+        T& operator*() const throw()
+        {
+            assert(this->ptr != NULL);
+
+            return *inplace_type::get_pointer(this->ptr);
+        }
+
+        T* operator->() const throw()
+        {
+            assert(this->ptr != NULL);
+
+            return inplace_type::get_pointer(this->ptr);
+        }
+
+        T* get() const throw()
+        {
+            return this->ptr == NULL ? NULL : inplace_type::get_pointer(this->ptr);
+        }
+
+        bool unique() const throw()
+        {
+            return this->use_count() == 1;
+        }
+
+        long use_count() const throw()
+        {
+            return this->ptr == NULL ? 0 : this->ptr->use_count();
+        }
+
+        // explicit operator bool
+        void unspecified_bool_type_func() const {}
+        typedef void (compact_shared_ptr::*unspecified_bool_type)() const;
+        operator unspecified_bool_type() const throw()
+        {
+            return !this->ptr ? NULL : &compact_shared_ptr::unspecified_bool_type_func;
+        }
+
+        void swap(compact_shared_ptr& that) throw()
+        {
+            std::swap(this->ptr, that.ptr);
+        }
+    };
+
+    template <typename T>
+    class compact_weak_ptr
+    {
+    public:
+        typedef T element_type;
+        typedef typename compact_shared_ptr<T>::inplace_type inplace_type;
+        typedef typename compact_shared_ptr<T>::counted_type counted_type;
+
+    private:
+        counted_type* ptr;
+
+    public:
+        compact_weak_ptr() throw()
+            : ptr(NULL) {}
+
+        compact_weak_ptr(const compact_shared_ptr<T>& that) throw()
+            : ptr(that.ptr)
+        {
+            if (this->ptr != NULL)
+            {
+                this->ptr->weak_add_ref();
+            }
+        }
+
+        // throws bad_weak_ptr if `that` was not created by make_shared<T> or is aliased
+        explicit compact_weak_ptr(const weak_ptr<T>& that)
+            : ptr(dynamic_cast<counted_type*>(that.get_counted()))
+        {
+            if (that.get_counted() != NULL && (this->ptr == NULL || inplace_type::get_pointer(this->ptr) != that.get_internal()))
+            {
+                SMART_PTR_THROW(bad_weak_ptr());
+            }
+
+            if (this->ptr != NULL)
+            {
+                this->ptr->weak_add_ref();
+            }
+        }
+
+        compact_weak_ptr(const compact_weak_ptr& that) throw()
+            : ptr(that.ptr)
+        {
+            if (this->ptr != NULL)
+            {
+                this->ptr->weak_add_ref();
+            }
+        }
+
+        ~compact_weak_ptr() throw()
+        {
+            if (this->ptr != NULL)
+            {
+                this->ptr->weak_release();
+            }
+        }
+
+        compact_weak_ptr& operator=(const compact_weak_ptr& that) throw()
+        {
+            compact_weak_ptr(that).swap(*this);
+            return *this;
+        }
+
+        compact_weak_ptr& operator=(const compact_shared_ptr<T>& that) throw()
+        {
+            compact_weak_ptr(that).swap(*this);
+            return *this;
+        }
+
+        operator weak_ptr<T>() const throw()
+        {
+            if (this->ptr == NULL)
+            {
+                return weak_ptr<T>();
+            }
+            this->ptr->weak_add_ref();
+            return weak_ptr<T>(_internal::adopt_tag(), inplace_type::get_pointer(this->ptr), this->ptr);
+        }
+
+        long use_count() const throw()
+        {
+            return this->ptr == NULL ? 0 : this->ptr->use_count();
+        }
+
+        bool expired() const throw()
+        {
+            return this->use_count() == 0;
+        }
+
+        compact_shared_ptr<T> lock() const throw()
+        {
+            if (this->ptr == NULL || !this->ptr->add_ref_lock())
+            {
+                return compact_shared_ptr<T>();
+            }
+            return compact_shared_ptr<T>(_internal::adopt_tag(), this->ptr);
+        }
+
+        void reset() throw()
+        {
+            compact_weak_ptr().swap(*this);
+        }
+
+        void swap(compact_weak_ptr& that) throw()
+        {
+            std::swap(this->ptr, that.ptr);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const compact_shared_ptr<T>& lhs, const compact_shared_ptr<U>& rhs) throw()
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const compact_shared_ptr<T>& lhs, const compact_shared_ptr<U>& rhs) throw()
+    {
+        return lhs.get() != rhs.get();
+    }
+
+    template <typename T, typename U>
+    bool operator<(const compact_shared_ptr<T>& lhs, const compact_shared_ptr<U>& rhs) throw()
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <typename T>
+    void swap(compact_shared_ptr<T>& lhs, compact_shared_ptr<T>& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+
+    template <typename T>
+    void swap(compact_weak_ptr<T>& lhs, compact_weak_ptr<T>& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,109 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+namespace ft
+{
+    // copy-on-write handle: copies share one object until one of them writes.
+    // write() copies the object only while it is shared.
+    // a reference from write() is invalidated by copying this handle.
+    template <typename T>
+    class cow_ptr
+    {
+    public:
+        typedef T element_type;
+
+    private:
+        ft::shared_ptr<T> ptr;
+
+    public:
+        cow_ptr()
+            : ptr() {}
+
+        explicit cow_ptr(const T& value)
+            : ptr(ft::make_shared<T>(value)) {}
+
+        explicit cow_ptr(const ft::shared_ptr<T>& ptr) throw()
+            : ptr(ptr) {}
+
+        cow_ptr(const cow_ptr& that) throw()
+            : ptr(that.ptr) {}
+
+        ~cow_ptr() {}
+
+        cow_ptr& operator=(const cow_ptr& that) throw()
+        {
+            this->ptr = that.ptr;
+            return *this;
+        }
+
+        const T& read() const throw()
+        {
+            assert(this->ptr);
+
+            return *this->ptr;
+        }
+
+        T& write()
+        {
+            assert(this->ptr);
+
+            if (!this->ptr.unique())
+            {
+                this->ptr = ft::make_shared<T>(static_cast<const T&>(*this->ptr));
+            }
+            return *this->ptr;
+        }
+
+        const T& operator*() const throw()
+        {
+            return this->read();
+        }
+
+        const T* operator->() const throw()
+        {
+            return &this->read();
+        }
+
+        bool unique() const throw()
+        {
+            return this->ptr.unique();
+        }
+
+        long use_count() const throw()
+        {
+            return this->ptr.use_count();
+        }
+
+        void reset() throw()
+        {
+            this->ptr.reset();
+        }
+
+        // explicit operator bool
+        void unspecified_bool_type_func() const {}
+        typedef void (cow_ptr::*unspecified_bool_type)() const;
+        operator unspecified_bool_type() const throw()
+        {
+            return !this->ptr ? NULL : &cow_ptr::unspecified_bool_type_func;
+        }
+
+        void swap(cow_ptr& that) throw()
+        {
+            this->ptr.swap(that.ptr);
+        }
+    };
+
+    template <typename T>
+    void swap(cow_ptr<T>& lhs, cow_ptr<T>& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -3,11 +3,72 @@
 
 #pragma once
 
+#include "_exception.hpp"
+#include "_hash.hpp"
+#include "_ref_counted.hpp"
+#include "bad_weak_ptr.hpp"
 #include "shared_ptr.hpp"
 #include "weak_ptr.hpp"
 
+#include <pthread.h>
+
+#include <cassert>
+#include <cstddef>
+
 namespace ft
 {
+    namespace _internal
+    {
+        // held while an expired owner of an enable_shared_from_this is replaced.
+        // one of a few mutexes, picked by the address of the object: replacements
+        // on the same object wait on each other, most on other objects do not
+        class ownership_guard
+        {
+        private:
+            enum
+            {
+                stripe_count = 16
+            };
+
+            pthread_mutex_t* handle;
+
+            ownership_guard(const ownership_guard&);
+            ownership_guard& operator=(const ownership_guard&);
+
+            static pthread_mutex_t* stripe(const void* object) throw()
+            {
+                static pthread_mutex_t stripes[stripe_count] = {
+                    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+                    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
+                return &stripes[mix_hash(reinterpret_cast<std::size_t>(object)) % stripe_count];
+            }
+
+        public:
+            explicit ownership_guard(const void* object) throw()
+                : handle(stripe(object))
+            {
+                int result = pthread_mutex_lock(this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+
+            ~ownership_guard() throw()
+            {
+                int result = pthread_mutex_unlock(this->handle);
+                assert(result == 0);
+                static_cast<void>(result);
+            }
+        };
+    }
+
+    // the object keeps a link to its control block, holding a weak reference on it.
+    // shared_from_this() takes a strong reference on that block directly, without the
+    // lookup of a separate weak_ptr. that reference is still taken by add_ref_lock(),
+    // under the mutex of the block, as every strong reference from a weak one is.
+    // as with std::enable_shared_from_this, shared_from_this() must not run while another
+    // shared_ptr takes ownership of the object; concurrent new owners are safe.
     template <typename T>
     class enable_shared_from_this
     {
@@ -16,30 +77,131 @@ namespace ft
         friend class shared_ptr;
 
     private:
-        mutable ft::weak_ptr<T> weak_this;
+        mutable _internal::_counted_base* owner;
 
     protected:
-        enable_shared_from_this() throw() {}
-        enable_shared_from_this(const enable_shared_from_this&) throw() {}
+        enable_shared_from_this() throw()
+            : owner(NULL) {}
+
+        enable_shared_from_this(const enable_shared_from_this&) throw()
+            : owner(NULL) {}
+
         enable_shared_from_this& operator=(const enable_shared_from_this&) throw() { return *this; }
-        ~enable_shared_from_this() throw() {}
+
+        ~enable_shared_from_this() throw()
+        {
+            _internal::_counted_base* counted = this->load_owner();
+            if (counted != NULL)
+            {
+                counted->weak_release();
+            }
+        }
 
     public:
-        ft::shared_ptr<T> shared_from_this() { return ft::shared_ptr<T>(this->weak_this); }
-        ft::shared_ptr<const T> shared_from_this() const { return ft::shared_ptr<const T>(this->weak_this); }
-        ft::weak_ptr<T> weak_from_this() throw() { return this->weak_this; }
-        ft::weak_ptr<const T> weak_from_this() const throw() { return this->weak_this; }
+        ft::shared_ptr<T> shared_from_this()
+        {
+            return ft::shared_ptr<T>(_internal::adopt_tag(), static_cast<T*>(this), this->lock_owner());
+        }
+
+        ft::shared_ptr<const T> shared_from_this() const
+        {
+            return ft::shared_ptr<const T>(_internal::adopt_tag(), static_cast<const T*>(this), this->lock_owner());
+        }
+
+        ft::weak_ptr<T> weak_from_this() throw()
+        {
+            _internal::_counted_base* counted = this->load_owner();
+            if (counted == NULL)
+            {
+                return ft::weak_ptr<T>();
+            }
+            counted->weak_add_ref();
+            return ft::weak_ptr<T>(_internal::adopt_tag(), static_cast<T*>(this), counted);
+        }
+
+        ft::weak_ptr<const T> weak_from_this() const throw()
+        {
+            _internal::_counted_base* counted = this->load_owner();
+            if (counted == NULL)
+            {
+                return ft::weak_ptr<const T>();
+            }
+            counted->weak_add_ref();
+            return ft::weak_ptr<const T>(_internal::adopt_tag(), static_cast<const T*>(this), counted);
+        }
 
     private:
+        _internal::_counted_base* load_owner() const throw()
+        {
+#ifdef __GNUC__
+            return __atomic_load_n(&this->owner, __ATOMIC_ACQUIRE);
+#else
+            return this->owner;
+#endif
+        }
+
+        // a strong reference on the owner, throws if there is none anymore
+        _internal::_counted_base* lock_owner() const
+        {
+            _internal::_counted_base* counted = this->load_owner();
+            if (counted == NULL || !counted->add_ref_lock())
+            {
+                SMART_PTR_THROW(bad_weak_ptr());
+            }
+            return counted;
+        }
+
+        // the first owner wins, an expired one is replaced
         template <typename TAlias, typename U>
-        void change_ownership(const ft::shared_ptr<TAlias>* alias, U* p) const throw()
+        void change_ownership(const ft::shared_ptr<TAlias>* alias, U*) const throw()
         {
-            // 아래 코드는 비원자적 연산으로 스레드 비안전함.
-            // 하지만 최초에만 쓰기 연산을 하고, 나머지 경우는 읽기 연산만 하므로 문제가 없다.
-            if (this->weak_this.expired())
+            _internal::_counted_base* counted = alias->get_counted();
+            if (counted == NULL)
+            {
+                return;
+            }
+
+#ifdef __GNUC__
+            // no owner yet, nothing to look at: a single compare and swap
+            _internal::_counted_base* unset = NULL;
+            counted->weak_add_ref();
+            if (__atomic_compare_exchange_n(&this->owner, &unset, counted, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                return;
+            }
+            counted->weak_release();
+            if (unset == counted)
             {
-                this->weak_this = ft::shared_ptr<T>(*alias, p);
+                return;
             }
+#endif
+
+            // a set owner is only replaced under the lock of this object, so the weak reference
+            // this object holds keeps it alive while its use count is read
+            _internal::_counted_base* expected;
+            {
+                _internal::ownership_guard guard(this);
+                expected = this->load_owner();
+                if (expected == counted || (expected != NULL && expected->use_count() != 0))
+                {
+                    return;
+                }
+                counted->weak_add_ref();
+                this->store_owner(counted);
+            }
+            if (expected != NULL)
+            {
+                expected->weak_release();
+            }
+        }
+
+        void store_owner(_internal::_counted_base* counted) const throw()
+        {
+#ifdef __GNUC__
+            __atomic_store_n(&this->owner, counted, __ATOMIC_RELEASE);
+#else
+            this->owner = counted;
+#endif
         }
     };
 }
@@ -0,0 +1,193 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_ptr_element.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#ifndef SMART_PTR_HUGE_PAGE_SIZE
+#define SMART_PTR_HUGE_PAGE_SIZE (2UL << 20)
+#endif
+
+// smaller blocks go through std::allocator
+#ifndef SMART_PTR_HUGE_PAGE_THRESHOLD
+#define SMART_PTR_HUGE_PAGE_THRESHOLD SMART_PTR_HUGE_PAGE_SIZE
+#endif
+
+namespace ft
+{
+    namespace _internal
+    {
+        inline std::size_t huge_page_round(std::size_t bytes) throw()
+        {
+            return (bytes + SMART_PTR_HUGE_PAGE_SIZE - 1) / SMART_PTR_HUGE_PAGE_SIZE * SMART_PTR_HUGE_PAGE_SIZE;
+        }
+
+        // log2 of the huge page size
+        inline int huge_page_shift() throw()
+        {
+            int shift = 0;
+            while ((static_cast<std::size_t>(1) << shift) < static_cast<std::size_t>(SMART_PTR_HUGE_PAGE_SIZE))
+            {
+                ++shift;
+            }
+            return shift;
+        }
+
+        // `bytes` is a multiple of the huge page size, NULL on failure
+        inline void* huge_page_map(std::size_t bytes) throw()
+        {
+#ifdef __linux__
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+            // only succeeds with pages reserved in the hugetlb pool. the page size is named,
+            // the default one of the host may be larger than the one lengths are rounded to
+            const int page_size_flag = huge_page_shift() << MAP_HUGE_SHIFT;
+            void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | page_size_flag, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                return p;
+            }
+#endif
+            // transparent huge pages need an aligned range, map with slack and trim both ends
+            const std::size_t slack = SMART_PTR_HUGE_PAGE_SIZE;
+            unsigned char* raw = static_cast<unsigned char*>(mmap(NULL, bytes + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED)
+            {
+                return NULL;
+            }
+            unsigned char* aligned = static_cast<unsigned char*>(align_pointer(raw, SMART_PTR_HUGE_PAGE_SIZE));
+            if (aligned != raw)
+            {
+                munmap(raw, aligned - raw);
+            }
+            if (aligned + bytes != raw + bytes + slack)
+            {
+                munmap(aligned + bytes, (raw + bytes + slack) - (aligned + bytes));
+            }
+#ifdef MADV_HUGEPAGE
+            static_cast<void>(madvise(aligned, bytes, MADV_HUGEPAGE));
+#endif
+            return aligned;
+#else
+            return ::operator new(bytes, std::nothrow);
+#endif
+        }
+
+        inline void huge_page_unmap(void* p, std::size_t bytes) throw()
+        {
+#ifdef __linux__
+            munmap(p, bytes);
+#else
+            static_cast<void>(bytes);
+            ::operator delete(p);
+#endif
+        }
+    }
+
+    // allocator mapping large blocks on huge pages, for allocate_shared of big arrays.
+    // blocks of SMART_PTR_HUGE_PAGE_THRESHOLD bytes or more get their own mapping,
+    // unmapped as soon as the last reference is released; smaller ones use std::allocator.
+    // hugetlb pages of SMART_PTR_HUGE_PAGE_SIZE are tried first, transparent huge pages are the fallback.
+    template <typename T>
+    class huge_page_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef huge_page_allocator<U> other;
+        };
+
+    public:
+        huge_page_allocator() throw() {}
+
+        huge_page_allocator(const huge_page_allocator&) throw() {}
+
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>&) throw() {}
+
+        ~huge_page_allocator() throw() {}
+
+        huge_page_allocator& operator=(const huge_page_allocator&) throw()
+        {
+            return *this;
+        }
+
+        T* allocate(std::size_t n, const void* = NULL)
+        {
+            if (n > this->max_size())
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+
+            if (!is_huge(n))
+            {
+                return std::allocator<T>().allocate(n);
+            }
+
+            void* p = _internal::huge_page_map(_internal::huge_page_round(n * sizeof(T)));
+            if (p == NULL)
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t n) throw()
+        {
+            if (!is_huge(n))
+            {
+                std::allocator<T>().deallocate(p, n);
+                return;
+            }
+
+            _internal::huge_page_unmap(p, _internal::huge_page_round(n * sizeof(T)));
+        }
+
+        std::size_t max_size() const throw()
+        {
+            return (static_cast<std::size_t>(-1) - SMART_PTR_HUGE_PAGE_SIZE) / sizeof(T);
+        }
+
+        T* address(T& x) const throw() { return _internal::addressof(x); }
+        const T* address(const T& x) const throw() { return _internal::addressof(x); }
+
+        void construct(T* p, const T& value) { ::new (static_cast<void*>(p)) T(value); }
+        void destroy(T* p) { p->~T(); }
+
+    private:
+        static bool is_huge(std::size_t n) throw()
+        {
+            return n * sizeof(T) >= SMART_PTR_HUGE_PAGE_THRESHOLD;
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&) throw()
+    {
+        return true;
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&) throw()
+    {
+        return false;
+    }
+}
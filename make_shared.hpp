@@ -3,74 +3,96 @@
 
 #pragma once
 
+#include "_allocator.hpp"
+#include "_exception.hpp"
 #include "shared_ptr.hpp"
 
+#include <cassert>
 #include <cstddef>
+#include <memory>
+#include <new>
+
+#ifndef SMART_PTR_CACHE_LINE_SIZE
+#define SMART_PTR_CACHE_LINE_SIZE 64
+#endif
 
 namespace ft
 {
     namespace _internal
     {
-        // single
+        // unbounded array storage, single objects and bounded arrays use _counted_impl_inplace
         template <typename T, typename TAlloc>
-        struct deleter_storage
-        {
-            typedef TAlloc allocate_type;
+        struct deleter_storage;
 
-            unsigned char data[sizeof(T)];
-            TAlloc alloc;
-            bool init;
+        // n objects aligned to at least `align`, allocated through TAlloc
+        template <typename T, typename TAlloc>
+        struct aligned_array
+        {
+            typedef typename _internal::rebind_alloc<TAlloc, T>::type object_allocate_type;
+            typedef typename _internal::rebind_alloc<TAlloc, _internal::max_align>::type unit_allocate_type;
 
-        public:
-            deleter_storage(const TAlloc& alloc) throw() : alloc(alloc), init(false) {}
-            deleter_storage(const deleter_storage& that) throw() : alloc(that.alloc), init(that.init) {}
-            ~deleter_storage() {}
+            T* data;
+            _internal::max_align* raw;
+            std::size_t n;
+            std::size_t units;
 
         public:
-            template <typename U>
-            void operator()(U* p) const throw()
+            aligned_array(const TAlloc& alloc, std::size_t n, std::size_t align)
+                : data(NULL), raw(NULL), n(n), units(0)
             {
-                if (!this->init)
+                assert(_internal::is_power_of_two(align));
+
+                if (align <= _internal::alignment_of<_internal::max_align>::value)
                 {
-                    return;
+                    object_allocate_type object_alloc(alloc);
+                    this->data = object_alloc.allocate(this->n);
                 }
+                else
+                {
+                    // slack for aligning the first object
+                    const std::size_t bytes = this->n * sizeof(T) + align - _internal::alignment_of<_internal::max_align>::value;
 
-                static_cast<T*>(p)->~T();
+                    unit_allocate_type unit_alloc(alloc);
+                    this->units = (bytes + sizeof(_internal::max_align) - 1) / sizeof(_internal::max_align);
+                    this->raw = unit_alloc.allocate(this->units);
+                    this->data = static_cast<T*>(_internal::align_pointer(this->raw, align));
+                }
             }
 
-        public:
-            T* get_data() throw() { return reinterpret_cast<T*>(this->data); }
-            T* get_dynamic() const throw() { return NULL; }
-            const allocate_type& get_allocator() const throw() { return this->alloc; }
-            std::size_t size() const throw() { return 1; }
-            void set() throw() { this->init = true; }
-
-        private:
-            deleter_storage& operator=(const deleter_storage&);
+            void deallocate(const TAlloc& alloc) const throw()
+            {
+                if (this->raw == NULL)
+                {
+                    object_allocate_type object_alloc(alloc);
+                    object_alloc.deallocate(this->data, this->n);
+                }
+                else
+                {
+                    unit_allocate_type unit_alloc(alloc);
+                    unit_alloc.deallocate(this->raw, this->units);
+                }
+            }
         };
 
-        // bounded array
-        template <typename T, std::size_t N, typename TAlloc>
-        struct deleter_storage<T[N], TAlloc>
+        // unbounded array
+        template <typename T, typename TAlloc>
+        struct deleter_storage<T[], TAlloc>
         {
             typedef TAlloc allocate_type;
             typedef typename _internal::scalar_type<T>::type single_type;
             static const std::size_t single_count = _internal::scalar_count<T>::value;
 
-            unsigned char data[N * sizeof(T)];
-            TAlloc alloc;
-            bool init;
+            aligned_array<T, TAlloc> array;
+            _internal::compressed_pair<bool, TAlloc> state; // init, alloc
 
         public:
-            deleter_storage(const TAlloc& alloc) throw() : alloc(alloc), init(false) {}
-            deleter_storage(const deleter_storage& that) throw() : alloc(that.alloc), init(that.init) {}
-            ~deleter_storage() {}
+            deleter_storage(const TAlloc& alloc, const aligned_array<T, TAlloc>& array) throw() : array(array), state(false, alloc) {}
+            deleter_storage(const deleter_storage& that) throw() : array(that.array), state(that.state) {}
 
-        public:
             template <typename U>
             void operator()(U* p) const throw()
             {
-                if (!this->init)
+                if (!this->state.first())
                 {
                     return;
                 }
@@ -81,67 +103,142 @@ namespace ft
                 {
                     arr[i].~single_type();
                 }
+
+                this->array.deallocate(this->state.second());
             }
 
         public:
-            T* get_data() throw() { return reinterpret_cast<T*>(this->data); }
-            T* get_dynamic() const throw() { return NULL; }
-            const allocate_type& get_allocator() const throw() { return this->alloc; }
-            std::size_t size() const throw() { return N * single_count; }
-            void set() throw() { this->init = true; }
+            T* get_data() throw() { return this->array.data; }
+            T* get_dynamic() const throw() { return this->array.data; }
+            const allocate_type& get_allocator() const throw() { return this->state.second(); }
+            std::size_t size() const throw() { return this->array.n * single_count; }
+            void set() throw() { this->state.first() = true; }
 
         private:
             deleter_storage& operator=(const deleter_storage&);
         };
 
-        // unbounded array
-        template <typename T, typename TAlloc>
-        struct deleter_storage<T[], TAlloc>
+        // layouts of _counted_impl_inplace
+        struct packed_layout
         {
-            typedef TAlloc allocate_type;
-            typedef typename _internal::scalar_type<T>::type single_type;
-            static const std::size_t single_count = _internal::scalar_count<T>::value;
+        };
 
-            T* data;
-            TAlloc alloc;
-            std::size_t n;
-            bool init;
+        // the object is kept off the cache line of the reference counts
+        struct isolated_layout
+        {
+        };
+
+        template <typename TStorage, typename TLayout>
+        struct inplace_payload
+        {
+            TStorage data;
+        };
 
+        template <typename TStorage>
+        struct inplace_payload<TStorage, isolated_layout>
+        {
+            unsigned char pad[SMART_PTR_CACHE_LINE_SIZE];
+            TStorage data;
+        };
+
+        // control block of allocate_shared for a single object or a bounded array.
+        // the object lives right in the block, its address is computed, not stored.
+        template <typename T, typename TAlloc, typename TLayout = packed_layout>
+        class _counted_impl_inplace : public _counted_base
+        {
         public:
-            deleter_storage(const TAlloc& alloc, T* data, std::size_t n) throw() : alloc(alloc), data(data), n(n), init(false) {}
-            deleter_storage(const deleter_storage& that) throw() : alloc(that.alloc), data(that.data), n(that.n), init(that.init) {}
+            typedef typename _internal::element_type<T>::type element_type;
+            typedef typename _internal::scalar_type<T>::type single_type;
 
-            template <typename U>
-            void operator()(U* p) const throw()
+        private:
+            typedef typename _internal::rebind_alloc<TAlloc, _counted_impl_inplace>::type alloc_type;
+            typedef _internal::aligned_storage<sizeof(T), _internal::alignment_of<T>::value> storage_type;
+
+            typedef inplace_payload<typename storage_type::type, TLayout> payload;
+
+            _internal::compressed_pair<payload, TAlloc> data;
+
+            _counted_impl_inplace(const _counted_impl_inplace&);
+            _counted_impl_inplace& operator=(const _counted_impl_inplace&);
+
+            explicit _counted_impl_inplace(const TAlloc& alloc) throw()
+                : data(_internal::default_first_tag(), alloc)
+            {
+                // Compile-time test
+                static_cast<void>(sizeof(char[!is_empty<TAlloc>::value || sizeof(_counted_impl_inplace) == sizeof(_counted_layout<payload>) ? 1 : -1]));
+            }
+
+        public:
+            // constructs the object with init, all or nothing
+            template <typename TInitializer>
+            static _counted_impl_inplace* create(const TAlloc& a, const TInitializer& init)
             {
-                if (!this->init)
+                alloc_type alloc_counted(a);
+                _internal::allocate_guard<alloc_type> guard(alloc_counted);
+
+                _counted_impl_inplace* counted = ::new (guard.get()) _counted_impl_inplace(a);
+                SMART_PTR_TRY
                 {
-                    return;
+                    init(*counted);
+                }
+                SMART_PTR_CATCH_ALL
+                {
+                    counted->~_counted_impl_inplace();
+                    SMART_PTR_RETHROW;
                 }
 
-                typedef typename TAlloc::template rebind<T>::other alloc_type;
-
-                alloc_type alloc(this->alloc);
+                guard.reset();
+                return counted;
+            }
 
-                single_type* const arr = reinterpret_cast<single_type*>(p);
-                const std::size_t n = this->size();
-                for (std::size_t i = 0; i < n; i++)
+            void dispose() throw()
+            {
+                single_type* const arr = reinterpret_cast<single_type*>(this->get_data());
+                for (std::size_t i = this->size(); i != 0; i--)
                 {
-                    arr[i].~single_type();
+                    arr[i - 1].~single_type();
                 }
+            }
 
-                alloc.deallocate(static_cast<T*>(p), this->n);
+            void destroy() throw()
+            {
+                alloc_type alloc_counted(this->data.second());
+                this->~_counted_impl_inplace();
+                alloc_counted.deallocate(this, 1);
             }
 
         public:
-            T* get_data() throw() { return this->data; }
-            T* get_dynamic() const throw() { return this->data; }
-            const allocate_type& get_allocator() const throw() { return this->alloc; }
-            std::size_t size() const throw() { return this->n * single_count; }
-            void set() throw() { this->init = true; }
+            // storage interface expected by the initializers
+            T* get_data() throw() { return static_cast<T*>(storage_type::address(this->data.first().data)); }
+            std::size_t size() const throw() { return _internal::scalar_count<T>::value; }
 
-        private:
-            deleter_storage& operator=(const deleter_storage&);
+            element_type* get_pointer() throw() { return reinterpret_cast<element_type*>(this->get_data()); }
+        };
+
+        template <typename T, typename TAlloc, typename TInitializer, typename TLayout>
+        ft::shared_ptr<T> allocate_inplace(const TAlloc& a, const TInitializer& init, TLayout)
+        {
+            typedef _counted_impl_inplace<T, TAlloc, TLayout> counted_type;
+
+            counted_type* counted = counted_type::create(a, init);
+            ft::shared_ptr<T> result(_internal::adopt_tag(), counted->get_pointer(), counted);
+            result.init_shared_from_this();
+            return result;
+        }
+
+        template <typename T, typename TAlloc, typename TInitializer>
+        ft::shared_ptr<T> allocate_inplace(const TAlloc& a, const TInitializer& init)
+        {
+            return allocate_inplace<T>(a, init, packed_layout());
+        }
+
+        // control block created by allocate_shared for a single object
+        template <typename T, typename TAlloc>
+        struct inplace_counted
+        {
+            typedef _counted_impl_inplace<T, TAlloc> type;
+
+            static T* get_pointer(type* counted) throw() { return counted->get_pointer(); }
         };
 
         // single init
@@ -407,21 +504,21 @@ namespace ft
                 std::size_t i = 0;
                 const std::size_t n = storage.size();
                 single_type* const arr = reinterpret_cast<single_type*>(storage.get_data());
-                try
+                SMART_PTR_TRY
                 {
                     for (; i < n; i++)
                     {
                         ::new (_internal::addressof(arr[i])) single_type;
                     }
                 }
-                catch (...)
+                SMART_PTR_CATCH_ALL
                 {
                     while (i != 0)
                     {
                         --i;
                         arr[i].~single_type();
                     }
-                    throw;
+                    SMART_PTR_RETHROW;
                 }
             }
 
@@ -448,181 +545,455 @@ namespace ft
                 std::size_t i = 0;
                 const std::size_t n = storage.size();
                 single_type* const arr = reinterpret_cast<single_type*>(storage.get_data());
-                try
+                SMART_PTR_TRY
                 {
                     for (; i < n; i++)
                     {
                         ::new (_internal::addressof(arr[i])) single_type(this->a1);
                     }
                 }
-                catch (...)
+                SMART_PTR_CATCH_ALL
                 {
                     while (i != 0)
                     {
                         --i;
                         arr[i].~single_type();
                     }
-                    throw;
+                    SMART_PTR_RETHROW;
                 }
             }
 
         private:
             array_initializer_1& operator=(const array_initializer_1&);
         };
+
+        // objects allocated apart from the control block, aligned to at least `align`.
+        // throws std::bad_alloc if `align` is not a power of two, a smaller one than alignof(T) is raised.
+        template <typename T, typename TAlloc, typename TInitializer>
+        ft::shared_ptr<T> allocate_dynamic(const TAlloc& a, std::size_t align, std::size_t n, TInitializer init)
+        {
+            typedef typename _internal::element_type<T>::type elem_type;
+            typedef typename _internal::rebind_alloc<TAlloc, elem_type>::type alloc_type;
+
+            if (!_internal::is_power_of_two(align))
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+            if (align < _internal::alignment_of<elem_type>::value)
+            {
+                align = _internal::alignment_of<elem_type>::value;
+            }
+
+            alloc_type alloc(a);
+            aligned_array<elem_type, alloc_type> array(alloc, n, align);
+            SMART_PTR_TRY
+            {
+                return ft::shared_ptr<T>(_internal::internal_tag(), deleter_storage<elem_type[], alloc_type>(alloc, array), init);
+            }
+            SMART_PTR_CATCH_ALL
+            {
+                array.deallocate(alloc);
+                SMART_PTR_RETHROW;
+            }
+        }
     }
 
     template <typename T, typename TAlloc>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_0<T>());
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_0<T>());
     }
 
     template <typename T, typename TAlloc, typename A1>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_1<T, A1>(a1));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_1<T, A1>(a1));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_2<T, A1, A2>(a1, a2));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_2<T, A1, A2>(a1, a2));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8));
     }
 
     template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
     typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
     }
 
     template <typename T, typename TAlloc>
     typename _internal::enable_if<_internal::is_bounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a)
     {
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::array_initializer_0<T>());
+        return _internal::allocate_inplace<T>(a, _internal::array_initializer_0<T>());
     }
 
     template <typename T, typename TAlloc>
     typename _internal::enable_if<_internal::is_bounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, const typename _internal::element_type<T>::type& def)
     {
         typedef typename _internal::element_type<T>::type elem_type;
-        return ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, TAlloc>(a), _internal::array_initializer_1<T, elem_type>(def));
+        return _internal::allocate_inplace<T>(a, _internal::array_initializer_1<T, elem_type>(def));
     }
 
     template <typename T, typename TAlloc>
     typename _internal::enable_if<_internal::is_unbounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, std::size_t n)
     {
-        typedef typename _internal::element_type<T>::type elem_type;
-        typedef typename TAlloc::template rebind<elem_type>::other alloc_type;
-        _internal::allocate_guard<alloc_type> guard(a, n);
-        ft::shared_ptr<T> result = ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, alloc_type>(a, guard.get(), n), _internal::array_initializer_0<T>());
-        guard.reset();
-        return result;
+        return _internal::allocate_dynamic<T>(a, 1, n, _internal::array_initializer_0<T>());
     }
 
     template <typename T, typename TAlloc>
     typename _internal::enable_if<_internal::is_unbounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared(const TAlloc& a, std::size_t n, const typename _internal::element_type<T>::type& def)
     {
         typedef typename _internal::element_type<T>::type elem_type;
-        typedef typename TAlloc::template rebind<elem_type>::other alloc_type;
-        _internal::allocate_guard<alloc_type> guard(a, n);
-        ft::shared_ptr<T> result = ft::shared_ptr<T>(_internal::internal_tag(), _internal::deleter_storage<T, alloc_type>(a, guard.get(), n), _internal::array_initializer_1<T, elem_type>(def));
-        guard.reset();
-        return result;
+        return _internal::allocate_dynamic<T>(a, 1, n, _internal::array_initializer_1<T, elem_type>(def));
     }
 
     template <typename T>
     ft::shared_ptr<T> make_shared()
     {
-        return ft::allocate_shared<T>(std::allocator<T>());
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type());
     }
 
     template <typename T, typename A1>
     ft::shared_ptr<T> make_shared(const A1& a1)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1);
     }
 
     template <typename T, typename A1, typename A2>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2);
     }
 
     template <typename T, typename A1, typename A2, typename A3>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4, a5);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4, a5, a6);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4, a5, a6, a7);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4, a5, a6, a7, a8);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7, a8);
     }
 
     template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
     ft::shared_ptr<T> make_shared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
     {
-        return ft::allocate_shared<T>(std::allocator<T>(), a1, a2, a3, a4, a5, a6, a7, a8, a9);
+        return ft::allocate_shared<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7, a8, a9);
+    }
+
+    template <typename T, typename TAlloc>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_0<T>(), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_1<T, A1>(a1), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_2<T, A1, A2>(a1, a2), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8), _internal::isolated_layout());
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_isolated(const TAlloc& a, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return _internal::allocate_inplace<T>(a, _internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9), _internal::isolated_layout());
+    }
+
+    template <typename T>
+    ft::shared_ptr<T> make_shared_isolated()
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type());
+    }
+
+    template <typename T, typename A1>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1);
+    }
+
+    template <typename T, typename A1, typename A2>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7, a8);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    ft::shared_ptr<T> make_shared_isolated(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return ft::allocate_shared_isolated<T>(typename _internal::default_allocator<T>::type(), a1, a2, a3, a4, a5, a6, a7, a8, a9);
+    }
+
+    template <typename T, typename TAlloc>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_0<T>());
+    }
+
+    template <typename T, typename TAlloc, typename A1>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_1<T, A1>(a1));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_2<T, A1, A2>(a1, a2));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, 1, _internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
+
+    template <typename T, typename TAlloc>
+    typename _internal::enable_if<_internal::is_unbounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, std::size_t n)
+    {
+        return _internal::allocate_dynamic<T>(a, alignment, n, _internal::array_initializer_0<T>());
+    }
+
+    template <typename T, typename TAlloc>
+    typename _internal::enable_if<_internal::is_unbounded_array<T>::value, ft::shared_ptr<T> >::type allocate_shared_aligned(const TAlloc& a, std::size_t alignment, std::size_t n, const typename _internal::element_type<T>::type& def)
+    {
+        typedef typename _internal::element_type<T>::type elem_type;
+        return _internal::allocate_dynamic<T>(a, alignment, n, _internal::array_initializer_1<T, elem_type>(def));
+    }
+
+    template <typename T>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment);
+    }
+
+    template <typename T, typename A1>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1);
+    }
+
+    template <typename T, typename A1, typename A2>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4, a5);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4, a5, a6);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4, a5, a6, a7);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4, a5, a6, a7, a8);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    ft::shared_ptr<T> make_shared_aligned(std::size_t alignment, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return ft::allocate_shared_aligned<T>(typename _internal::default_allocator<T>::type(), alignment, a1, a2, a3, a4, a5, a6, a7, a8, a9);
     }
 }
@@ -0,0 +1,376 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_allocator.hpp"
+#include "_exception.hpp"
+#include "_ptr_element.hpp"
+#include "_ref_counted.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ft
+{
+    namespace _internal
+    {
+        // n objects placed right after the control block, in the same allocation
+        template <typename T, typename TAlloc>
+        class _counted_impl_batch : public _counted_base
+        {
+        private:
+            typedef typename _internal::rebind_alloc<TAlloc, _counted_impl_batch>::type alloc_type;
+
+            static const std::size_t slack = alignment_of<T>::value > alignment_of<_counted_impl_batch>::value ? alignment_of<T>::value - alignment_of<_counted_impl_batch>::value : 0;
+
+            std::size_t units;
+            _internal::compressed_pair<std::size_t, TAlloc> count; // constructed objects, alloc
+
+            _counted_impl_batch(const _counted_impl_batch&);
+            _counted_impl_batch& operator=(const _counted_impl_batch&);
+
+            _counted_impl_batch(const TAlloc& alloc, std::size_t n, std::size_t units) throw()
+                : units(units), count(n, alloc)
+            {
+                // Compile-time test
+                static_cast<void>(sizeof(char[!is_empty<TAlloc>::value || sizeof(_counted_impl_batch) == sizeof(_counted_layout<std::size_t[2]>) ? 1 : -1]));
+            }
+
+        public:
+            // constructs every object with init, all or nothing
+            template <typename TInitializer>
+            static _counted_impl_batch* create(const TAlloc& a, std::size_t n, const TInitializer& init)
+            {
+                const std::size_t bytes = sizeof(_counted_impl_batch) + slack + n * sizeof(T);
+                const std::size_t units = (bytes + sizeof(_counted_impl_batch) - 1) / sizeof(_counted_impl_batch);
+
+                alloc_type alloc_counted(a);
+                _internal::allocate_guard<alloc_type> guard(alloc_counted, units);
+
+                _counted_impl_batch* counted = ::new (guard.get()) _counted_impl_batch(a, 0, units);
+
+                T* const arr = counted->get_pointer();
+                std::size_t& constructed = counted->count.first();
+                SMART_PTR_TRY
+                {
+                    for (; constructed < n; constructed++)
+                    {
+                        slot s(arr + constructed);
+                        init(s);
+                    }
+                }
+                SMART_PTR_CATCH_ALL
+                {
+                    counted->dispose();
+                    counted->~_counted_impl_batch();
+                    SMART_PTR_RETHROW;
+                }
+
+                guard.reset();
+                return counted;
+            }
+
+            void dispose() throw()
+            {
+                T* const arr = this->get_pointer();
+                for (std::size_t i = this->count.first(); i != 0; i--)
+                {
+                    arr[i - 1].~T();
+                }
+            }
+
+            void destroy() throw()
+            {
+                alloc_type alloc_counted(this->count.second());
+                const std::size_t units = this->units;
+                this->~_counted_impl_batch();
+                alloc_counted.deallocate(this, units);
+            }
+
+        public:
+            T* get_pointer() throw()
+            {
+                unsigned char* const end = reinterpret_cast<unsigned char*>(this) + sizeof(_counted_impl_batch);
+                if (slack == 0)
+                {
+                    return reinterpret_cast<T*>(end);
+                }
+                return static_cast<T*>(align_pointer(end, alignment_of<T>::value));
+            }
+
+            std::size_t size() const throw() { return this->count.first(); }
+
+        private:
+            // storage interface expected by the initializers
+            struct slot
+            {
+                T* p;
+
+                explicit slot(T* p) throw() : p(p) {}
+                T* get_data() const throw() { return this->p; }
+            };
+        };
+
+        // objects constructed side by side in one make_shared block
+        template <typename A, typename B, typename C>
+        struct group
+        {
+            A first;
+            B second;
+            C third;
+
+        public:
+            group() : first(), second(), third() {}
+
+            template <typename TA, typename TB, typename TC>
+            group(const TA& a, const TB& b, const TC& c) : first(a), second(b), third(c) {}
+        };
+
+        template <typename A, typename B>
+        struct group<A, B, void>
+        {
+            A first;
+            B second;
+
+        public:
+            group() : first(), second() {}
+
+            template <typename TA, typename TB>
+            group(const TA& a, const TB& b) : first(a), second(b) {}
+        };
+
+        template <typename T, typename TAlloc, typename TInitializer>
+        std::vector<ft::shared_ptr<T> > allocate_batch(const TAlloc& a, std::size_t n, const TInitializer& init)
+        {
+            typedef _counted_impl_batch<T, TAlloc> counted_type;
+
+            // empty pointers, allocated before the objects
+            std::vector<ft::shared_ptr<T> > result(n);
+
+            counted_type* counted = counted_type::create(a, n, init);
+            if (n == 0)
+            {
+                counted->release();
+                return result;
+            }
+
+            // the first element takes the reference of the creation, the others are added in one step
+            if (n > 1)
+            {
+                counted->add_ref_copy(n - 1);
+            }
+
+            T* const arr = counted->get_pointer();
+            for (std::size_t i = 0; i < n; i++)
+            {
+                ft::shared_ptr<T>(_internal::adopt_tag(), arr + i, counted).swap(result[i]);
+                result[i].init_shared_from_this();
+            }
+            return result;
+        }
+    }
+
+    // a make_shared_group result, every member shares one control block
+    template <typename A, typename B, typename C = void>
+    struct shared_group
+    {
+        ft::shared_ptr<A> first;
+        ft::shared_ptr<B> second;
+        ft::shared_ptr<C> third;
+    };
+
+    template <typename A, typename B>
+    struct shared_group<A, B, void>
+    {
+        ft::shared_ptr<A> first;
+        ft::shared_ptr<B> second;
+    };
+
+    template <typename T, typename TAlloc>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_0<T>());
+    }
+
+    template <typename T, typename TAlloc, typename A1>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_1<T, A1>(a1));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_2<T, A1, A2>(a1, a2));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template <typename T, typename TAlloc, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    typename _internal::enable_if<!_internal::is_array<T>::value, std::vector<ft::shared_ptr<T> > >::type allocate_shared_batch(const TAlloc& a, std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return _internal::allocate_batch<T>(a, n, _internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
+
+    template <typename T>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n);
+    }
+
+    template <typename T, typename A1>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1);
+    }
+
+    template <typename T, typename A1, typename A2>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4, a5);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4, a5, a6);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4, a5, a6, a7);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4, a5, a6, a7, a8);
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    std::vector<ft::shared_ptr<T> > make_shared_batch(std::size_t n, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return ft::allocate_shared_batch<T>(typename _internal::default_allocator<T>::type(), n, a1, a2, a3, a4, a5, a6, a7, a8, a9);
+    }
+
+    template <typename A, typename B>
+    shared_group<A, B> make_shared_group()
+    {
+        typedef _internal::group<A, B, void> group_type;
+
+        const ft::shared_ptr<group_type> owner = ft::make_shared<group_type>();
+
+        shared_group<A, B> result;
+        result.first = ft::shared_ptr<A>(owner, &owner->first);
+        result.first.init_shared_from_this();
+        result.second = ft::shared_ptr<B>(owner, &owner->second);
+        result.second.init_shared_from_this();
+        return result;
+    }
+
+    template <typename A, typename B, typename TA, typename TB>
+    shared_group<A, B> make_shared_group(const TA& a, const TB& b)
+    {
+        typedef _internal::group<A, B, void> group_type;
+
+        const ft::shared_ptr<group_type> owner = ft::make_shared<group_type>(a, b);
+
+        shared_group<A, B> result;
+        result.first = ft::shared_ptr<A>(owner, &owner->first);
+        result.first.init_shared_from_this();
+        result.second = ft::shared_ptr<B>(owner, &owner->second);
+        result.second.init_shared_from_this();
+        return result;
+    }
+
+    template <typename A, typename B, typename C>
+    shared_group<A, B, C> make_shared_group()
+    {
+        typedef _internal::group<A, B, C> group_type;
+
+        const ft::shared_ptr<group_type> owner = ft::make_shared<group_type>();
+
+        shared_group<A, B, C> result;
+        result.first = ft::shared_ptr<A>(owner, &owner->first);
+        result.first.init_shared_from_this();
+        result.second = ft::shared_ptr<B>(owner, &owner->second);
+        result.second.init_shared_from_this();
+        result.third = ft::shared_ptr<C>(owner, &owner->third);
+        result.third.init_shared_from_this();
+        return result;
+    }
+
+    template <typename A, typename B, typename C, typename TA, typename TB, typename TC>
+    shared_group<A, B, C> make_shared_group(const TA& a, const TB& b, const TC& c)
+    {
+        typedef _internal::group<A, B, C> group_type;
+
+        const ft::shared_ptr<group_type> owner = ft::make_shared<group_type>(a, b, c);
+
+        shared_group<A, B, C> result;
+        result.first = ft::shared_ptr<A>(owner, &owner->first);
+        result.first.init_shared_from_this();
+        result.second = ft::shared_ptr<B>(owner, &owner->second);
+        result.second.init_shared_from_this();
+        result.third = ft::shared_ptr<C>(owner, &owner->third);
+        result.third.init_shared_from_this();
+        return result;
+    }
+}
@@ -0,0 +1,405 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_mutex.hpp"
+#include "_ptr_element.hpp"
+#include "_ref_counted.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+#include "weak_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace ft
+{
+    class cycle_tracer;
+
+    namespace _internal
+    {
+        class cycle_collector;
+
+        // control block of make_shared_collectable, linked into the registry of the collector
+        class _collectable_base : public _counted_base
+        {
+        private:
+            friend class ft::cycle_tracer;
+            friend class cycle_collector;
+
+        private:
+            _collectable_base* gc_prev;
+            _collectable_base* gc_next;
+            long gc_refs;  // references not explained by other collectable objects
+            bool gc_live;  // reachable from outside during a collection
+            bool disposed; // the object is gone, by its last owner or by the collector
+
+            _collectable_base(const _collectable_base&);
+            _collectable_base& operator=(const _collectable_base&);
+
+        protected:
+            _collectable_base() throw()
+                : gc_prev(NULL), gc_next(NULL), gc_refs(0), gc_live(false), disposed(false) {}
+
+            virtual void dispose_object() = 0; // throw()
+
+            // every shared_ptr the object holds goes through `tracer`
+            virtual void trace_object(ft::cycle_tracer& tracer) = 0;
+
+        public:
+            void dispose() throw()
+            {
+                if (!this->disposed)
+                {
+                    this->disposed = true;
+                    this->dispose_object();
+                }
+            }
+        };
+
+        // every live collectable block, guarded by one mutex
+        class cycle_collector
+        {
+        private:
+            mutex lock;
+            _collectable_base* head;
+
+            cycle_collector(const cycle_collector&);
+            cycle_collector& operator=(const cycle_collector&);
+
+            cycle_collector() throw()
+                : lock(), head(NULL) {}
+
+        public:
+            // lives until the process exits, blocks may be released from static destructors
+            static cycle_collector& instance()
+            {
+                static cycle_collector* const collector = ::new cycle_collector();
+                return *collector;
+            }
+
+            void link(_collectable_base* counted) throw()
+            {
+                mutex_guard guard(this->lock);
+                counted->gc_prev = NULL;
+                counted->gc_next = this->head;
+                if (this->head != NULL)
+                {
+                    this->head->gc_prev = counted;
+                }
+                this->head = counted;
+            }
+
+            void unlink(_collectable_base* counted) throw()
+            {
+                mutex_guard guard(this->lock);
+                if (counted->gc_prev != NULL)
+                {
+                    counted->gc_prev->gc_next = counted->gc_next;
+                }
+                else
+                {
+                    this->head = counted->gc_next;
+                }
+                if (counted->gc_next != NULL)
+                {
+                    counted->gc_next->gc_prev = counted->gc_prev;
+                }
+            }
+
+            inline std::size_t collect();
+        };
+    }
+
+    // visits the shared_ptr members of a collectable object, see make_shared_collectable
+    class cycle_tracer
+    {
+    private:
+        friend class _internal::cycle_collector;
+
+        enum mode
+        {
+            subtract, // each edge explains one reference of its target
+            mark,     // each edge makes its target reachable
+            clear     // each edge is emptied, its reference kept in `detached`
+        };
+
+    private:
+        mode phase;
+        std::vector<_internal::_collectable_base*>* pending;
+        std::vector<_internal::_counted_base*>* detached;
+
+        cycle_tracer(mode phase, std::vector<_internal::_collectable_base*>* pending, std::vector<_internal::_counted_base*>* detached) throw()
+            : phase(phase), pending(pending), detached(detached) {}
+
+        cycle_tracer(const cycle_tracer&);
+        cycle_tracer& operator=(const cycle_tracer&);
+
+    public:
+        template <typename U>
+        void operator()(const ft::shared_ptr<U>& p)
+        {
+            if (this->phase == clear)
+            {
+                // the object is garbage, nothing else reads it anymore
+                _internal::_counted_base* counted = const_cast<ft::shared_ptr<U>&>(p).detach();
+                if (counted != NULL)
+                {
+                    this->detached->push_back(counted);
+                }
+                return;
+            }
+            this->visit(p.get_counted());
+        }
+
+        // weak edges never keep an object alive
+        template <typename U>
+        void operator()(const ft::weak_ptr<U>&) throw() {}
+
+    private:
+        void visit(_internal::_counted_base* counted)
+        {
+            _internal::_collectable_base* target = dynamic_cast<_internal::_collectable_base*>(counted);
+            if (target == NULL || target->disposed)
+            {
+                return;
+            }
+
+            if (this->phase == subtract)
+            {
+                --target->gc_refs;
+            }
+            else if (!target->gc_live)
+            {
+                target->gc_live = true;
+                this->pending->push_back(target);
+            }
+        }
+    };
+
+    namespace _internal
+    {
+        template <typename T>
+        class _counted_impl_collectable : public _collectable_base
+        {
+        private:
+            typedef _internal::aligned_storage<sizeof(T), _internal::alignment_of<T>::value> storage_type;
+
+            typename storage_type::type data;
+
+            _counted_impl_collectable() throw() {}
+
+            _counted_impl_collectable(const _counted_impl_collectable&);
+            _counted_impl_collectable& operator=(const _counted_impl_collectable&);
+
+        public:
+            // constructs the object with init, then registers the block
+            template <typename TInitializer>
+            static _counted_impl_collectable* create(const TInitializer& init)
+            {
+                _counted_impl_collectable* counted = ::new _counted_impl_collectable();
+                SMART_PTR_TRY
+                {
+                    init(*counted);
+                }
+                SMART_PTR_CATCH_ALL
+                {
+                    ::delete counted;
+                    SMART_PTR_RETHROW;
+                }
+
+                cycle_collector::instance().link(counted);
+                return counted;
+            }
+
+            void destroy() throw()
+            {
+                cycle_collector::instance().unlink(this);
+                ::delete this;
+            }
+
+        protected:
+            void dispose_object() throw()
+            {
+                this->get_data()->~T();
+            }
+
+            void trace_object(ft::cycle_tracer& tracer)
+            {
+                const T& object = *this->get_data();
+                object.trace(tracer);
+            }
+
+        public:
+            // storage interface expected by the initializers
+            T* get_data() throw() { return static_cast<T*>(storage_type::address(this->data)); }
+        };
+
+        // trial deletion: references a collectable object gets from other collectable objects are
+        // subtracted from its count, what is left comes from outside. objects not reachable from
+        // such an object only keep each other alive: their traced edges are emptied, then they
+        // are disposed, then the references of those edges are released.
+        inline std::size_t cycle_collector::collect()
+        {
+            std::vector<_collectable_base*> garbage;
+            std::vector<_counted_base*> edges;
+            {
+                mutex_guard guard(this->lock);
+
+                std::vector<_collectable_base*> pending;
+                for (_collectable_base* counted = this->head; counted != NULL; counted = counted->gc_next)
+                {
+                    counted->gc_refs = counted->disposed ? 0 : counted->use_count();
+                    counted->gc_live = false;
+                }
+
+                ft::cycle_tracer subtract(ft::cycle_tracer::subtract, NULL, NULL);
+                for (_collectable_base* counted = this->head; counted != NULL; counted = counted->gc_next)
+                {
+                    if (!counted->disposed)
+                    {
+                        counted->trace_object(subtract);
+                    }
+                }
+
+                ft::cycle_tracer mark(ft::cycle_tracer::mark, &pending, NULL);
+                for (_collectable_base* counted = this->head; counted != NULL; counted = counted->gc_next)
+                {
+                    if (!counted->disposed && counted->gc_refs > 0 && !counted->gc_live)
+                    {
+                        counted->gc_live = true;
+                        pending.push_back(counted);
+                    }
+                    while (!pending.empty())
+                    {
+                        _collectable_base* live = pending.back();
+                        pending.pop_back();
+                        live->trace_object(mark);
+                    }
+                }
+
+                for (_collectable_base* counted = this->head; counted != NULL; counted = counted->gc_next)
+                {
+                    if (!counted->disposed && !counted->gc_live && counted->use_count() != 0)
+                    {
+                        garbage.push_back(counted);
+                    }
+                }
+
+                // keeps every block of the cycles alive while their objects release each other
+                for (std::size_t i = 0; i < garbage.size(); i++)
+                {
+                    garbage[i]->add_ref_copy();
+                }
+
+                // no destructor can reach a sibling destroyed before it
+                ft::cycle_tracer clear(ft::cycle_tracer::clear, NULL, &edges);
+                for (std::size_t i = 0; i < garbage.size(); i++)
+                {
+                    garbage[i]->trace_object(clear);
+                }
+            }
+
+            for (std::size_t i = 0; i < garbage.size(); i++)
+            {
+                garbage[i]->dispose();
+            }
+            for (std::size_t i = 0; i < edges.size(); i++)
+            {
+                edges[i]->release();
+            }
+            for (std::size_t i = 0; i < garbage.size(); i++)
+            {
+                garbage[i]->release();
+            }
+            return garbage.size();
+        }
+
+        template <typename T, typename TInitializer>
+        ft::shared_ptr<T> allocate_collectable(const TInitializer& init)
+        {
+            typedef _counted_impl_collectable<T> counted_type;
+
+            counted_type* counted = counted_type::create(init);
+            ft::shared_ptr<T> result(_internal::adopt_tag(), counted->get_data(), counted);
+            result.init_shared_from_this();
+            return result;
+        }
+    }
+
+    // reclaims the collectable objects that are only kept alive by reference cycles,
+    // returns how many were disposed. the collection is synchronous: other threads must not
+    // copy, assign or release shared pointers of collectable objects while it runs.
+    inline std::size_t collect_cycles()
+    {
+        return _internal::cycle_collector::instance().collect();
+    }
+
+    // a shared object whose reference cycles collect_cycles() can reclaim.
+    // T enumerates the shared pointers it holds with a member
+    //     void trace(ft::cycle_tracer& tracer) const { tracer(this->child); ... }
+    // before collect_cycles() destroys an object, it empties every shared pointer its trace()
+    // visits, so the destructor finds them empty rather than pointing at destroyed objects.
+
+    template <typename T>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable()
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_0<T>());
+    }
+
+    template <typename T, typename A1>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_1<T, A1>(a1));
+    }
+
+    template <typename T, typename A1, typename A2>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_2<T, A1, A2>(a1, a2));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_3<T, A1, A2, A3>(a1, a2, a3));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_4<T, A1, A2, A3, A4>(a1, a2, a3, a4));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_5<T, A1, A2, A3, A4, A5>(a1, a2, a3, a4, a5));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_6<T, A1, A2, A3, A4, A5, A6>(a1, a2, a3, a4, a5, a6));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_7<T, A1, A2, A3, A4, A5, A6, A7>(a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_8<T, A1, A2, A3, A4, A5, A6, A7, A8>(a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    typename _internal::enable_if<!_internal::is_array<T>::value, ft::shared_ptr<T> >::type make_shared_collectable(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return _internal::allocate_collectable<T>(_internal::single_initializer_9<T, A1, A2, A3, A4, A5, A6, A7, A8, A9>(a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
+}
@@ -0,0 +1,135 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_ptr_element.hpp"
+#include "shared_ptr.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+
+namespace ft
+{
+    // access hints of map_shared, may be combined with map_populate
+    enum map_flags
+    {
+        map_normal = 0,
+        map_sequential = 1 << 0, // aggressive read-ahead, pages dropped early
+        map_random = 1 << 1,     // no read-ahead
+        map_populate = 1 << 2    // fault every page in before returning
+    };
+
+    namespace _internal
+    {
+        // unmaps the whole mapping, the shared pointer may start past its first page
+        struct unmap_deleter
+        {
+            void* base;
+            std::size_t size;
+
+        public:
+            unmap_deleter(void* base, std::size_t size) throw()
+                : base(base), size(size) {}
+
+            template <typename U>
+            void operator()(U*) const throw()
+            {
+                munmap(this->base, this->size);
+            }
+        };
+    }
+
+    // `length` bytes of the file at `path` from byte `offset`, mapped read only.
+    // both are in bytes, `length` must be a multiple of sizeof(T).
+    // nothing is copied, pages are read on first access unless map_populate is given.
+    // empty with errno set if the file can not be opened or mapped, or EINVAL if `length`
+    // is 0, not a multiple of sizeof(T), `offset` is not aligned for T,
+    // or the range ends past the end of the file.
+    template <typename T>
+    typename _internal::enable_if<_internal::is_unbounded_array<T>::value, shared_ptr<const typename _internal::element_type<T>::type[]> >::type map_shared(const char* path, std::size_t offset, std::size_t length, int flags = map_normal)
+    {
+        typedef const typename _internal::element_type<T>::type elem_type;
+
+        if (length == 0 || length % sizeof(elem_type) != 0)
+        {
+            errno = EINVAL;
+            return shared_ptr<elem_type[]>();
+        }
+
+        if (offset % _internal::alignment_of<elem_type>::value != 0)
+        {
+            errno = EINVAL;
+            return shared_ptr<elem_type[]>();
+        }
+
+        int oflag = O_RDONLY;
+#ifdef O_CLOEXEC
+        oflag |= O_CLOEXEC;
+#endif
+        const int fd = open(path, oflag);
+        if (fd < 0)
+        {
+            return shared_ptr<elem_type[]>();
+        }
+
+        // pages past the end of the file would raise SIGBUS on access
+        struct stat st;
+        const int error = fstat(fd, &st) != 0 ? errno : 0;
+        if (error != 0 || offset > static_cast<std::size_t>(st.st_size) || length > static_cast<std::size_t>(st.st_size) - offset)
+        {
+            close(fd);
+            errno = error != 0 ? error : EINVAL;
+            return shared_ptr<elem_type[]>();
+        }
+
+        // mmap offsets are page aligned
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t skip = offset % page;
+        const std::size_t size = skip + length;
+
+        int mflag = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if (flags & map_populate)
+        {
+            mflag |= MAP_POPULATE;
+        }
+#endif
+        void* base = mmap(NULL, size, PROT_READ, mflag, fd, static_cast<off_t>(offset - skip));
+        const int map_error = errno;
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            errno = map_error;
+            return shared_ptr<elem_type[]>();
+        }
+
+        if (flags & map_sequential)
+        {
+            static_cast<void>(madvise(base, size, MADV_SEQUENTIAL));
+        }
+        else if (flags & map_random)
+        {
+            static_cast<void>(madvise(base, size, MADV_RANDOM));
+        }
+
+        elem_type* p = reinterpret_cast<elem_type*>(static_cast<unsigned char*>(base) + skip);
+        return shared_ptr<elem_type[]>(p, _internal::unmap_deleter(base, size));
+    }
+
+    // elements of `p` from `first` on, sharing the ownership of `p`.
+    // a slice of a mapped file keeps the whole mapping alive, no new mapping is made.
+    template <typename T>
+    typename _internal::enable_if<_internal::is_unbounded_array<T>::value, shared_ptr<T> >::type slice_shared(const shared_ptr<T>& p, std::size_t first) throw()
+    {
+        assert(p.get() != NULL || first == 0);
+
+        return shared_ptr<T>(p, p.get() + first);
+    }
+}
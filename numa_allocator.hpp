@@ -0,0 +1,365 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_mutex.hpp"
+#include "_ptr_element.hpp"
+#include "shared_ptr.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#ifndef SMART_PTR_NUMA_MAX_NODES
+#define SMART_PTR_NUMA_MAX_NODES 64
+#endif
+
+namespace ft
+{
+    namespace _internal
+    {
+        // <numaif.h> is part of libnuma, not of the C library
+        static const int numa_mpol_preferred = 1;
+        static const int numa_mpol_f_node = 1 << 0;
+        static const int numa_mpol_f_addr = 1 << 1;
+        static const int numa_mpol_f_mems_allowed = 1 << 2;
+
+        static const std::size_t numa_mask_words = (SMART_PTR_NUMA_MAX_NODES + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8);
+
+        inline int numa_current_node() throw()
+        {
+#if defined(__linux__) && defined(SYS_getcpu)
+            unsigned int cpu = 0;
+            unsigned int node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < SMART_PTR_NUMA_MAX_NODES)
+            {
+                return static_cast<int>(node);
+            }
+#endif
+            return 0;
+        }
+
+        inline int numa_node_count() throw()
+        {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+            unsigned long mask[numa_mask_words] = {};
+            if (syscall(SYS_get_mempolicy, NULL, mask, SMART_PTR_NUMA_MAX_NODES + 1, NULL, numa_mpol_f_mems_allowed) == 0)
+            {
+                int last = -1;
+                for (int node = 0; node < SMART_PTR_NUMA_MAX_NODES; node++)
+                {
+                    if (mask[node / (sizeof(unsigned long) * 8)] & (1UL << (node % (sizeof(unsigned long) * 8))))
+                    {
+                        last = node;
+                    }
+                }
+                if (last >= 0)
+                {
+                    return last + 1;
+                }
+            }
+#endif
+            return 1;
+        }
+
+        // -1 if unknown, the page must have been touched
+        inline int numa_node_of_address(const void* p) throw()
+        {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+            int node = -1;
+            if (p != NULL && syscall(SYS_get_mempolicy, &node, NULL, 0, p, numa_mpol_f_node | numa_mpol_f_addr) == 0)
+            {
+                return node;
+            }
+#else
+            static_cast<void>(p);
+#endif
+            return -1;
+        }
+
+        inline std::size_t numa_page_size() throw()
+        {
+#ifdef __linux__
+            static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+
+        // pages placed on `node`, NULL on failure
+        inline void* numa_map(std::size_t bytes, int node) throw()
+        {
+#ifdef __linux__
+            void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+            {
+                return NULL;
+            }
+#ifdef SYS_mbind
+            // preferred, not bound: a full or missing node falls back to any other one
+            unsigned long mask[numa_mask_words] = {};
+            mask[node / (sizeof(unsigned long) * 8)] = 1UL << (node % (sizeof(unsigned long) * 8));
+            static_cast<void>(syscall(SYS_mbind, p, bytes, numa_mpol_preferred, mask, SMART_PTR_NUMA_MAX_NODES + 1, 0));
+#else
+            static_cast<void>(node);
+#endif
+            return p;
+#else
+            static_cast<void>(node);
+            return ::operator new(bytes, std::nothrow);
+#endif
+        }
+
+        inline void numa_unmap(void* p, std::size_t bytes) throw()
+        {
+#ifdef __linux__
+            munmap(p, bytes);
+#else
+            static_cast<void>(bytes);
+            ::operator delete(p);
+#endif
+        }
+
+        // memory of one node: small blocks carved from chunks into per size free lists,
+        // large ones mapped on their own. small blocks are reused, never unmapped.
+        class numa_heap
+        {
+        private:
+            static const std::size_t granule = 16;
+            static const std::size_t max_small = 1024;
+            static const std::size_t chunk_size = 1 << 20;
+
+            struct free_block
+            {
+                free_block* next;
+            };
+
+            mutex lock;
+            int node;
+            unsigned char* cursor;
+            unsigned char* end;
+            free_block* free_lists[max_small / granule];
+
+            numa_heap(const numa_heap&);
+            numa_heap& operator=(const numa_heap&);
+
+        public:
+            explicit numa_heap(int node) throw()
+                : lock(), node(node), cursor(NULL), end(NULL)
+            {
+                for (std::size_t i = 0; i < max_small / granule; i++)
+                {
+                    this->free_lists[i] = NULL;
+                }
+            }
+
+            static bool is_small(std::size_t bytes, std::size_t align) throw()
+            {
+                return bytes <= max_small && align <= granule;
+            }
+
+            void* allocate(std::size_t bytes, std::size_t align) throw()
+            {
+                if (!is_small(bytes, align))
+                {
+                    assert(align <= numa_page_size());
+
+                    return numa_map(round_up(bytes, numa_page_size()), this->node);
+                }
+
+                const std::size_t size = round_up(bytes == 0 ? 1 : bytes, granule);
+                free_block*& list = this->free_lists[size / granule - 1];
+
+                mutex_guard guard(this->lock);
+                if (list != NULL)
+                {
+                    free_block* block = list;
+                    list = block->next;
+                    return block;
+                }
+                if (static_cast<std::size_t>(this->end - this->cursor) < size)
+                {
+                    // the tail of the old chunk is abandoned
+                    unsigned char* chunk = static_cast<unsigned char*>(numa_map(chunk_size, this->node));
+                    if (chunk == NULL)
+                    {
+                        return NULL;
+                    }
+                    this->cursor = chunk;
+                    this->end = chunk + chunk_size;
+                }
+                void* p = this->cursor;
+                this->cursor += size;
+                return p;
+            }
+
+            void deallocate(void* p, std::size_t bytes, std::size_t align) throw()
+            {
+                if (!is_small(bytes, align))
+                {
+                    numa_unmap(p, round_up(bytes, numa_page_size()));
+                    return;
+                }
+
+                const std::size_t size = round_up(bytes == 0 ? 1 : bytes, granule);
+                free_block*& list = this->free_lists[size / granule - 1];
+
+                mutex_guard guard(this->lock);
+                free_block* block = static_cast<free_block*>(p);
+                block->next = list;
+                list = block;
+            }
+
+        private:
+            static std::size_t round_up(std::size_t value, std::size_t to) throw()
+            {
+                return (value + to - 1) / to * to;
+            }
+        };
+
+        // heaps live until the process exits, blocks may be released from static destructors
+        inline numa_heap** numa_create_heaps()
+        {
+            numa_heap** heaps = ::new numa_heap*[SMART_PTR_NUMA_MAX_NODES];
+            for (int node = 0; node < SMART_PTR_NUMA_MAX_NODES; node++)
+            {
+                heaps[node] = ::new numa_heap(node);
+            }
+            return heaps;
+        }
+
+        inline numa_heap& numa_heap_of(int node)
+        {
+            static numa_heap** const heaps = numa_create_heaps();
+            return *heaps[node];
+        }
+    }
+
+    // node of the calling thread's cpu, 0 if unknown
+    inline int numa_current_node() throw()
+    {
+        return _internal::numa_current_node();
+    }
+
+    // number of memory nodes this process may use, 1 without NUMA support
+    inline int numa_node_count() throw()
+    {
+        return _internal::numa_node_count();
+    }
+
+    // node holding the control block of `p`, -1 if empty or unknown
+    template <typename T>
+    int numa_node_of(const shared_ptr<T>& p) throw()
+    {
+        return _internal::numa_node_of_address(p.get_counted());
+    }
+
+    // allocator placing memory on one NUMA node, for allocate_shared.
+    // with allocate_shared the control block and the object share that node.
+    // a default constructed allocator picks the node of the thread creating it.
+    // on machines or kernels without NUMA every node request lands on the only node.
+    template <typename T>
+    class numa_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef numa_allocator<U> other;
+        };
+
+    private:
+        template <typename U>
+        friend class numa_allocator;
+
+    private:
+        int target;
+
+    public:
+        numa_allocator() throw()
+            : target(_internal::numa_current_node()) {}
+
+        explicit numa_allocator(int node) throw()
+            : target(node >= 0 && node < SMART_PTR_NUMA_MAX_NODES ? node : 0) {}
+
+        numa_allocator(const numa_allocator& that) throw()
+            : target(that.target) {}
+
+        template <typename U>
+        numa_allocator(const numa_allocator<U>& that) throw()
+            : target(that.target) {}
+
+        ~numa_allocator() throw() {}
+
+        numa_allocator& operator=(const numa_allocator& that) throw()
+        {
+            this->target = that.target;
+            return *this;
+        }
+
+        int node() const throw()
+        {
+            return this->target;
+        }
+
+        T* allocate(std::size_t n, const void* = NULL)
+        {
+            if (n > this->max_size())
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+
+            void* p = _internal::numa_heap_of(this->target).allocate(n * sizeof(T), _internal::alignment_of<T>::value);
+            if (p == NULL)
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t n) throw()
+        {
+            _internal::numa_heap_of(this->target).deallocate(p, n * sizeof(T), _internal::alignment_of<T>::value);
+        }
+
+        std::size_t max_size() const throw()
+        {
+            return static_cast<std::size_t>(-1) / sizeof(T);
+        }
+
+        T* address(T& x) const throw() { return _internal::addressof(x); }
+        const T* address(const T& x) const throw() { return _internal::addressof(x); }
+
+        void construct(T* p, const T& value) { ::new (static_cast<void*>(p)) T(value); }
+        void destroy(T* p) { p->~T(); }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const numa_allocator<T>& lhs, const numa_allocator<U>& rhs) throw()
+    {
+        return lhs.node() == rhs.node();
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const numa_allocator<T>& lhs, const numa_allocator<U>& rhs) throw()
+    {
+        return lhs.node() != rhs.node();
+    }
+}
@@ -0,0 +1,95 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "shared_ptr.hpp"
+#include "weak_ptr.hpp"
+
+#include <cstddef>
+
+namespace ft
+{
+    template <typename T = void>
+    struct owner_less;
+
+    template <typename T>
+    struct owner_less<shared_ptr<T> >
+    {
+        typedef bool result_type;
+        typedef shared_ptr<T> first_argument_type;
+        typedef shared_ptr<T> second_argument_type;
+
+        bool operator()(const shared_ptr<T>& lhs, const shared_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+
+        bool operator()(const shared_ptr<T>& lhs, const weak_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+
+        bool operator()(const weak_ptr<T>& lhs, const shared_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+    };
+
+    template <typename T>
+    struct owner_less<weak_ptr<T> >
+    {
+        typedef bool result_type;
+        typedef weak_ptr<T> first_argument_type;
+        typedef weak_ptr<T> second_argument_type;
+
+        bool operator()(const weak_ptr<T>& lhs, const weak_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+
+        bool operator()(const shared_ptr<T>& lhs, const weak_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+
+        bool operator()(const weak_ptr<T>& lhs, const shared_ptr<T>& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+    };
+
+    template <>
+    struct owner_less<void>
+    {
+        typedef void is_transparent;
+
+        template <typename T, typename U>
+        bool operator()(const T& lhs, const U& rhs) const throw()
+        {
+            return lhs.owner_before(rhs);
+        }
+    };
+
+    struct owner_hash
+    {
+        typedef void is_transparent;
+
+        template <typename T>
+        std::size_t operator()(const T& p) const throw()
+        {
+            return p.owner_hash();
+        }
+    };
+
+    struct owner_equal
+    {
+        typedef void is_transparent;
+
+        template <typename T, typename U>
+        bool operator()(const T& lhs, const U& rhs) const throw()
+        {
+            return lhs.owner_equal(rhs);
+        }
+    };
+}
@@ -0,0 +1,319 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_hash.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace ft
+{
+    // hash map with structural sharing, backed by a hash array mapped trie of shared nodes.
+    // copying is O(1) and gives an immutable snapshot of the contents.
+    // updates copy only the shared nodes on the path they touch,
+    // nodes owned by this map alone are edited in place.
+    template <typename K, typename V, typename THash = _internal::hash<K>, typename TEqual = std::equal_to<K> >
+    class persistent_map
+    {
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::size_t size_type;
+
+    private:
+        static const unsigned int bits = 5;
+        static const std::size_t mask = (static_cast<std::size_t>(1) << bits) - 1;
+        static const unsigned int hash_bits = sizeof(std::size_t) * 8;
+
+        struct entry
+        {
+            std::size_t hash;
+            K key;
+            V value;
+
+            entry(std::size_t hash, const K& key, const V& value)
+                : hash(hash), key(key), value(value) {}
+        };
+
+        // entries and children are ordered by their bit in datamap and nodemap.
+        // below the last level every entry shares one hash and both maps are unused.
+        struct node
+        {
+            unsigned int datamap;
+            unsigned int nodemap;
+            std::vector<entry> entries;
+            std::vector<ft::shared_ptr<node> > children;
+
+            node()
+                : datamap(0), nodemap(0), entries(), children() {}
+        };
+
+    private:
+        ft::shared_ptr<node> root;
+        std::size_t count;
+        THash hasher;
+        TEqual equal;
+
+    public:
+        explicit persistent_map(const THash& hasher = THash(), const TEqual& equal = TEqual())
+            : root(), count(0), hasher(hasher), equal(equal) {}
+
+        persistent_map(const persistent_map& that)
+            : root(that.root), count(that.count), hasher(that.hasher), equal(that.equal) {}
+
+        ~persistent_map() {}
+
+        persistent_map& operator=(const persistent_map& that)
+        {
+            persistent_map(that).swap(*this);
+            return *this;
+        }
+
+        // NULL if absent
+        const V* find(const K& key) const
+        {
+            const std::size_t hash = this->hasher(key);
+
+            const node* n = this->root.get();
+            for (unsigned int shift = 0; n != NULL; shift += bits)
+            {
+                if (shift >= hash_bits)
+                {
+                    for (std::size_t i = 0; i < n->entries.size(); i++)
+                    {
+                        if (this->equal(n->entries[i].key, key))
+                        {
+                            return &n->entries[i].value;
+                        }
+                    }
+                    return NULL;
+                }
+
+                const unsigned int bit = bit_of(hash, shift);
+                if (n->datamap & bit)
+                {
+                    const entry& e = n->entries[index_of(n->datamap, bit)];
+                    return e.hash == hash && this->equal(e.key, key) ? &e.value : NULL;
+                }
+                if (!(n->nodemap & bit))
+                {
+                    return NULL;
+                }
+                n = n->children[index_of(n->nodemap, bit)].get();
+            }
+            return NULL;
+        }
+
+        bool contains(const K& key) const
+        {
+            return this->find(key) != NULL;
+        }
+
+        // true if the key was not present before
+        bool set(const K& key, const V& value)
+        {
+            if (!this->root)
+            {
+                this->root = ft::make_shared<node>();
+            }
+
+            const bool inserted = this->set(this->root, 0, entry(this->hasher(key), key, value));
+            if (inserted)
+            {
+                ++this->count;
+            }
+            return inserted;
+        }
+
+        // true if the key was present
+        bool erase(const K& key)
+        {
+            // nothing to copy for a missing key
+            if (this->find(key) == NULL)
+            {
+                return false;
+            }
+
+            this->erase(this->root, 0, this->hasher(key), key);
+            if (--this->count == 0)
+            {
+                this->root.reset();
+            }
+            return true;
+        }
+
+        // f(key, value) for every entry, in unspecified order
+        template <typename TFunction>
+        void for_each(TFunction f) const
+        {
+            if (this->root)
+            {
+                for_each(*this->root, f);
+            }
+        }
+
+        void clear() throw()
+        {
+            this->root.reset();
+            this->count = 0;
+        }
+
+        std::size_t size() const throw()
+        {
+            return this->count;
+        }
+
+        bool empty() const throw()
+        {
+            return this->count == 0;
+        }
+
+        void swap(persistent_map& that)
+        {
+            this->root.swap(that.root);
+            std::swap(this->count, that.count);
+            std::swap(this->hasher, that.hasher);
+            std::swap(this->equal, that.equal);
+        }
+
+    private:
+        static unsigned int bit_of(std::size_t hash, unsigned int shift) throw()
+        {
+            return 1U << ((hash >> shift) & mask);
+        }
+
+        static std::size_t index_of(unsigned int map, unsigned int bit) throw()
+        {
+            unsigned int value = map & (bit - 1);
+            value = value - ((value >> 1) & 0x55555555U);
+            value = (value & 0x33333333U) + ((value >> 2) & 0x33333333U);
+            return (((value + (value >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+        }
+
+        static node* editable(ft::shared_ptr<node>& n)
+        {
+            if (!n.unique())
+            {
+                n = ft::make_shared<node>(*n);
+            }
+            return n.get();
+        }
+
+        bool set(ft::shared_ptr<node>& slot, unsigned int shift, const entry& e)
+        {
+            node* n = editable(slot);
+
+            if (shift >= hash_bits)
+            {
+                for (std::size_t i = 0; i < n->entries.size(); i++)
+                {
+                    if (this->equal(n->entries[i].key, e.key))
+                    {
+                        n->entries[i].value = e.value;
+                        return false;
+                    }
+                }
+                n->entries.push_back(e);
+                return true;
+            }
+
+            const unsigned int bit = bit_of(e.hash, shift);
+            if (n->datamap & bit)
+            {
+                const std::size_t i = index_of(n->datamap, bit);
+                if (n->entries[i].hash == e.hash && this->equal(n->entries[i].key, e.key))
+                {
+                    n->entries[i].value = e.value;
+                    return false;
+                }
+
+                // both entries move one level down
+                ft::shared_ptr<node> child = ft::make_shared<node>();
+                this->set(child, shift + bits, n->entries[i]);
+                this->set(child, shift + bits, e);
+
+                n->entries.erase(n->entries.begin() + i);
+                n->datamap &= ~bit;
+                n->children.insert(n->children.begin() + index_of(n->nodemap, bit), child);
+                n->nodemap |= bit;
+                return true;
+            }
+            if (n->nodemap & bit)
+            {
+                return this->set(n->children[index_of(n->nodemap, bit)], shift + bits, e);
+            }
+
+            n->entries.insert(n->entries.begin() + index_of(n->datamap, bit), e);
+            n->datamap |= bit;
+            return true;
+        }
+
+        // the key must be present
+        void erase(ft::shared_ptr<node>& slot, unsigned int shift, std::size_t hash, const K& key)
+        {
+            node* n = editable(slot);
+
+            if (shift >= hash_bits)
+            {
+                for (std::size_t i = 0; i < n->entries.size(); i++)
+                {
+                    if (this->equal(n->entries[i].key, key))
+                    {
+                        n->entries.erase(n->entries.begin() + i);
+                        return;
+                    }
+                }
+                return;
+            }
+
+            const unsigned int bit = bit_of(hash, shift);
+            if (n->datamap & bit)
+            {
+                n->entries.erase(n->entries.begin() + index_of(n->datamap, bit));
+                n->datamap &= ~bit;
+                return;
+            }
+
+            const std::size_t i = index_of(n->nodemap, bit);
+            this->erase(n->children[i], shift + bits, hash, key);
+
+            const node& child = *n->children[i];
+            if (child.children.empty() && child.entries.size() <= 1)
+            {
+                // pull a single remaining entry back up, drop an empty child
+                if (!child.entries.empty())
+                {
+                    n->entries.insert(n->entries.begin() + index_of(n->datamap, bit), child.entries[0]);
+                    n->datamap |= bit;
+                }
+                n->children.erase(n->children.begin() + i);
+                n->nodemap &= ~bit;
+            }
+        }
+
+        template <typename TFunction>
+        static void for_each(const node& n, TFunction& f)
+        {
+            for (std::size_t i = 0; i < n.entries.size(); i++)
+            {
+                f(n.entries[i].key, n.entries[i].value);
+            }
+            for (std::size_t i = 0; i < n.children.size(); i++)
+            {
+                for_each(*n.children[i], f);
+            }
+        }
+    };
+
+    template <typename K, typename V, typename THash, typename TEqual>
+    void swap(persistent_map<K, V, THash, TEqual>& lhs, persistent_map<K, V, THash, TEqual>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,218 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace ft
+{
+    // vector with structural sharing, backed by a 32-way trie of shared nodes.
+    // copying is O(1) and gives an immutable snapshot of the contents.
+    // updates copy only the shared nodes on the path they touch,
+    // nodes owned by this vector alone are edited in place.
+    // T must be default constructible and assignable.
+    template <typename T>
+    class persistent_vector
+    {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+    private:
+        static const unsigned int bits = 5;
+        static const std::size_t width = static_cast<std::size_t>(1) << bits;
+        static const std::size_t mask = width - 1;
+
+        struct leaf
+        {
+            T values[width];
+        };
+
+        struct branch
+        {
+            ft::shared_ptr<void> child[width];
+        };
+
+    private:
+        ft::shared_ptr<void> root;
+        std::size_t count;
+        unsigned int shift;
+
+    public:
+        persistent_vector()
+            : root(), count(0), shift(0) {}
+
+        persistent_vector(const persistent_vector& that)
+            : root(that.root), count(that.count), shift(that.shift) {}
+
+        ~persistent_vector() {}
+
+        persistent_vector& operator=(const persistent_vector& that)
+        {
+            persistent_vector(that).swap(*this);
+            return *this;
+        }
+
+        const T& operator[](std::size_t i) const throw()
+        {
+            assert(i < this->count);
+
+            const void* node = this->root.get();
+            for (unsigned int level = this->shift; level > 0; level -= bits)
+            {
+                node = static_cast<const branch*>(node)->child[(i >> level) & mask].get();
+            }
+            return static_cast<const leaf*>(node)->values[i & mask];
+        }
+
+        const T& back() const throw()
+        {
+            assert(this->count != 0);
+
+            return (*this)[this->count - 1];
+        }
+
+        void set(std::size_t i, const T& value)
+        {
+            assert(i < this->count);
+
+            ft::shared_ptr<void>* slot = &this->root;
+            for (unsigned int level = this->shift; level > 0; level -= bits)
+            {
+                slot = &editable_branch(*slot)->child[(i >> level) & mask];
+            }
+            editable_leaf(*slot)->values[i & mask] = value;
+        }
+
+        void push_back(const T& value)
+        {
+            if (!this->root)
+            {
+                this->root = ft::make_shared<leaf>();
+            }
+            else if (this->count == this->capacity())
+            {
+                ft::shared_ptr<branch> grown = ft::make_shared<branch>();
+                grown->child[0] = this->root;
+                this->root = grown;
+                this->shift += bits;
+            }
+
+            const std::size_t i = this->count;
+            ft::shared_ptr<void>* slot = &this->root;
+            for (unsigned int level = this->shift; level > 0; level -= bits)
+            {
+                slot = &editable_branch(*slot)->child[(i >> level) & mask];
+                if (!*slot)
+                {
+                    if (level == bits)
+                    {
+                        *slot = ft::make_shared<leaf>();
+                    }
+                    else
+                    {
+                        *slot = ft::make_shared<branch>();
+                    }
+                }
+            }
+            editable_leaf(*slot)->values[i & mask] = value;
+            ++this->count;
+        }
+
+        void pop_back()
+        {
+            assert(this->count != 0);
+
+            const std::size_t i = --this->count;
+            if (i == 0)
+            {
+                this->root.reset();
+                this->shift = 0;
+                return;
+            }
+
+            ft::shared_ptr<void>* slot = &this->root;
+            unsigned int level = this->shift;
+            for (; level > 0; level -= bits)
+            {
+                branch* node = editable_branch(*slot);
+                slot = &node->child[(i >> level) & mask];
+                if ((i & ((static_cast<std::size_t>(1) << level) - 1)) == 0)
+                {
+                    // the whole subtree is past the end
+                    slot->reset();
+                    break;
+                }
+            }
+            if (level == 0)
+            {
+                editable_leaf(*slot)->values[i & mask] = T();
+            }
+
+            while (this->shift > 0 && this->count <= (static_cast<std::size_t>(1) << this->shift))
+            {
+                ft::shared_ptr<void> first = static_cast<branch*>(this->root.get())->child[0];
+                this->root = first;
+                this->shift -= bits;
+            }
+        }
+
+        void clear() throw()
+        {
+            persistent_vector().swap(*this);
+        }
+
+        std::size_t size() const throw()
+        {
+            return this->count;
+        }
+
+        bool empty() const throw()
+        {
+            return this->count == 0;
+        }
+
+        void swap(persistent_vector& that) throw()
+        {
+            this->root.swap(that.root);
+            std::swap(this->count, that.count);
+            std::swap(this->shift, that.shift);
+        }
+
+    private:
+        std::size_t capacity() const throw()
+        {
+            return static_cast<std::size_t>(1) << (this->shift + bits);
+        }
+
+        static branch* editable_branch(ft::shared_ptr<void>& node)
+        {
+            if (!node.unique())
+            {
+                node = ft::make_shared<branch>(*static_cast<const branch*>(node.get()));
+            }
+            return static_cast<branch*>(node.get());
+        }
+
+        static leaf* editable_leaf(ft::shared_ptr<void>& node)
+        {
+            if (!node.unique())
+            {
+                node = ft::make_shared<leaf>(*static_cast<const leaf*>(node.get()));
+            }
+            return static_cast<leaf*>(node.get());
+        }
+    };
+
+    template <typename T>
+    void swap(persistent_vector<T>& lhs, persistent_vector<T>& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+}
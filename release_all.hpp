@@ -0,0 +1,47 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_ref_counted.hpp"
+#include "shared_ptr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace ft
+{
+    // empties every shared pointer in [first, last), with one release per control block
+    template <typename TForwardIt>
+    void release_all(TForwardIt first, TForwardIt last)
+    {
+        std::vector<_internal::_counted_base*> blocks;
+        for (TForwardIt it = first; it != last; ++it)
+        {
+            if (it->get_counted() != NULL)
+            {
+                blocks.push_back(it->get_counted());
+            }
+        }
+
+        // nothing is released if collecting throws
+        for (; first != last; ++first)
+        {
+            first->detach();
+        }
+
+        std::sort(blocks.begin(), blocks.end(), std::less<_internal::_counted_base*>());
+        for (std::size_t i = 0; i != blocks.size();)
+        {
+            std::size_t j = i + 1;
+            while (j != blocks.size() && blocks[j] == blocks[i])
+            {
+                ++j;
+            }
+            blocks[i]->release(j - i);
+            i = j;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_ref_counted.hpp"
+
+#include <cstddef>
+
+namespace ft
+{
+    // blocks of this thread left over by a release_budget.
+    // always 0 without SMART_PTR_ITERATIVE_RELEASE.
+    inline std::size_t pending_releases() throw()
+    {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        _internal::release_worklist* list = _internal::release_worklist::current();
+        return list == NULL ? 0 : list->pending;
+#else
+        return 0;
+#endif
+    }
+
+    // disposes up to `budget` blocks left over on this thread, returns the number left.
+    // call it at a safe point, such as between two requests.
+    inline std::size_t drain_releases(std::size_t budget = static_cast<std::size_t>(-1)) throw()
+    {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+        _internal::release_worklist* list = _internal::release_worklist::current();
+        return list == NULL ? 0 : list->drain(budget);
+#else
+        static_cast<void>(budget);
+        return 0;
+#endif
+    }
+
+    // while alive, a release on this thread disposes at most `budget` objects,
+    // the rest is left for a later release or drain_releases().
+    // does nothing without SMART_PTR_ITERATIVE_RELEASE.
+    class release_budget
+    {
+    private:
+        std::size_t previous;
+
+        release_budget(const release_budget&);
+        release_budget& operator=(const release_budget&);
+
+    public:
+        explicit release_budget(std::size_t budget) throw()
+            : previous(static_cast<std::size_t>(-1))
+        {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+            _internal::release_worklist* list = _internal::release_worklist::current();
+            if (list != NULL)
+            {
+                this->previous = list->budget;
+                list->budget = budget;
+            }
+#else
+            static_cast<void>(budget);
+#endif
+        }
+
+        ~release_budget() throw()
+        {
+#ifdef SMART_PTR_ITERATIVE_RELEASE
+            _internal::release_worklist* list = _internal::release_worklist::current();
+            if (list != NULL)
+            {
+                list->budget = this->previous;
+            }
+#endif
+        }
+    };
+}
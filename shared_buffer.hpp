@@ -0,0 +1,342 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+
+namespace ft
+{
+    // byte range of a shared allocation. copies and slices share the bytes, nothing is copied
+    // until mutable_data() is called on a range whose allocation is shared or borrowed.
+    class shared_buffer
+    {
+    private:
+        // aliases the first byte of the range
+        ft::shared_ptr<unsigned char[]> bytes;
+        std::size_t length;
+        bool borrowed; // bytes of an owner given to the constructor, possibly read only
+
+    public:
+        shared_buffer() throw()
+            : bytes(), length(0), borrowed(false) {}
+
+        // uninitialized
+        explicit shared_buffer(std::size_t n)
+            : bytes(n == 0 ? ft::shared_ptr<unsigned char[]>() : ft::make_shared<unsigned char[]>(n)), length(n), borrowed(false) {}
+
+        shared_buffer(const void* data, std::size_t n)
+            : bytes(n == 0 ? ft::shared_ptr<unsigned char[]>() : ft::make_shared<unsigned char[]>(n)), length(n), borrowed(false)
+        {
+            if (n != 0)
+            {
+                std::memcpy(this->bytes.get(), data, n);
+            }
+        }
+
+        // `n` bytes at `p`, kept alive by `owner`. they are never written,
+        // mutable_data() always copies them first.
+        template <typename T>
+        shared_buffer(const ft::shared_ptr<T>& owner, const void* p, std::size_t n) throw()
+            : bytes(owner, static_cast<unsigned char*>(const_cast<void*>(p))), length(n), borrowed(true) {}
+
+        shared_buffer(const shared_buffer& that) throw()
+            : bytes(that.bytes), length(that.length), borrowed(that.borrowed) {}
+
+        ~shared_buffer() throw() {}
+
+        shared_buffer& operator=(const shared_buffer& that) throw()
+        {
+            this->bytes = that.bytes;
+            this->length = that.length;
+            this->borrowed = that.borrowed;
+            return *this;
+        }
+
+        const unsigned char* data() const throw()
+        {
+            return this->bytes.get();
+        }
+
+        // copies the range first if the allocation is shared with another buffer or borrowed
+        unsigned char* mutable_data()
+        {
+            if (this->length != 0 && (this->borrowed || !this->bytes.unique()))
+            {
+                shared_buffer(this->bytes.get(), this->length).swap(*this);
+            }
+            return this->bytes.get();
+        }
+
+        std::size_t size() const throw()
+        {
+            return this->length;
+        }
+
+        bool empty() const throw()
+        {
+            return this->length == 0;
+        }
+
+        bool unique() const throw()
+        {
+            return this->bytes.unique();
+        }
+
+        const unsigned char& operator[](std::size_t i) const throw()
+        {
+            assert(i < this->length);
+
+            return this->bytes.get()[i];
+        }
+
+        // bytes [pos, pos + n), sharing the allocation
+        shared_buffer slice(std::size_t pos, std::size_t n = static_cast<std::size_t>(-1)) const throw()
+        {
+            assert(pos <= this->length);
+
+            shared_buffer result;
+            result.length = std::min(n, this->length - pos);
+            if (result.length != 0)
+            {
+                result.bytes.reset(this->bytes, this->bytes.get() + pos);
+                result.borrowed = this->borrowed;
+            }
+            return result;
+        }
+
+        // drops the first `n` bytes
+        void remove_prefix(std::size_t n) throw()
+        {
+            *this = this->slice(n);
+        }
+
+        // keeps the first `n` bytes
+        void truncate(std::size_t n) throw()
+        {
+            *this = this->slice(0, n);
+        }
+
+        void swap(shared_buffer& that) throw()
+        {
+            this->bytes.swap(that.bytes);
+            std::swap(this->length, that.length);
+            std::swap(this->borrowed, that.borrowed);
+        }
+    };
+
+    inline void swap(shared_buffer& lhs, shared_buffer& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+
+    // sequence of shared buffers read as one byte stream.
+    // append, prepend and split move buffer handles, the bytes are never copied.
+    class buffer_chain
+    {
+    private:
+        std::deque<shared_buffer> buffers;
+        std::size_t length;
+
+    public:
+        buffer_chain()
+            : buffers(), length(0) {}
+
+        explicit buffer_chain(const shared_buffer& buffer)
+            : buffers(), length(0)
+        {
+            this->append(buffer);
+        }
+
+        buffer_chain(const buffer_chain& that)
+            : buffers(that.buffers), length(that.length) {}
+
+        ~buffer_chain() {}
+
+        buffer_chain& operator=(const buffer_chain& that)
+        {
+            buffer_chain(that).swap(*this);
+            return *this;
+        }
+
+        std::size_t size() const throw()
+        {
+            return this->length;
+        }
+
+        bool empty() const throw()
+        {
+            return this->length == 0;
+        }
+
+        std::size_t buffer_count() const throw()
+        {
+            return this->buffers.size();
+        }
+
+        const shared_buffer& buffer(std::size_t i) const throw()
+        {
+            assert(i < this->buffers.size());
+
+            return this->buffers[i];
+        }
+
+        void append(const shared_buffer& buffer)
+        {
+            if (!buffer.empty())
+            {
+                this->buffers.push_back(buffer);
+                this->length += buffer.size();
+            }
+        }
+
+        void append(const buffer_chain& that)
+        {
+            if (&that == this)
+            {
+                // insert() may not read from the deque it inserts into
+                this->append(buffer_chain(that));
+                return;
+            }
+            this->buffers.insert(this->buffers.end(), that.buffers.begin(), that.buffers.end());
+            this->length += that.length;
+        }
+
+        void prepend(const shared_buffer& buffer)
+        {
+            if (!buffer.empty())
+            {
+                this->buffers.push_front(buffer);
+                this->length += buffer.size();
+            }
+        }
+
+        void prepend(const buffer_chain& that)
+        {
+            if (&that == this)
+            {
+                this->prepend(buffer_chain(that));
+                return;
+            }
+            this->buffers.insert(this->buffers.begin(), that.buffers.begin(), that.buffers.end());
+            this->length += that.length;
+        }
+
+        // removes the first `n` bytes and returns them, a buffer across the cut is sliced
+        buffer_chain split(std::size_t n)
+        {
+            assert(n <= this->length);
+
+            buffer_chain head;
+            while (n != 0)
+            {
+                shared_buffer& front = this->buffers.front();
+                if (front.size() <= n)
+                {
+                    n -= front.size();
+                    head.append(front);
+                    this->length -= front.size();
+                    this->buffers.pop_front();
+                }
+                else
+                {
+                    head.append(front.slice(0, n));
+                    front.remove_prefix(n);
+                    this->length -= n;
+                    n = 0;
+                }
+            }
+            return head;
+        }
+
+        // drops the first `n` bytes, such as those a partial writev() sent
+        void consume(std::size_t n) throw()
+        {
+            assert(n <= this->length);
+
+            this->length -= n;
+            while (n != 0)
+            {
+                shared_buffer& front = this->buffers.front();
+                if (front.size() <= n)
+                {
+                    n -= front.size();
+                    this->buffers.pop_front();
+                }
+                else
+                {
+                    front.remove_prefix(n);
+                    n = 0;
+                }
+            }
+        }
+
+        // the chain flattened into one buffer, only copies when it has more than one
+        shared_buffer coalesce() const
+        {
+            if (this->buffers.size() <= 1)
+            {
+                return this->buffers.empty() ? shared_buffer() : this->buffers.front();
+            }
+
+            shared_buffer result(this->length);
+            unsigned char* out = result.mutable_data();
+            for (std::deque<shared_buffer>::const_iterator it = this->buffers.begin(); it != this->buffers.end(); ++it)
+            {
+                std::memcpy(out, it->data(), it->size());
+                out += it->size();
+            }
+            return result;
+        }
+
+        // fills up to `count` entries for writev(), returns the number filled
+        std::size_t to_iovec(struct iovec* out, std::size_t count) const throw()
+        {
+            const std::size_t n = std::min(count, this->buffers.size());
+            for (std::size_t i = 0; i < n; i++)
+            {
+                out[i].iov_base = const_cast<unsigned char*>(this->buffers[i].data());
+                out[i].iov_len = this->buffers[i].size();
+            }
+            return n;
+        }
+
+        // as to_iovec, for readv(): shared buffers are copied first so reading does not show through
+        std::size_t to_mutable_iovec(struct iovec* out, std::size_t count)
+        {
+            const std::size_t n = std::min(count, this->buffers.size());
+            for (std::size_t i = 0; i < n; i++)
+            {
+                out[i].iov_base = this->buffers[i].mutable_data();
+                out[i].iov_len = this->buffers[i].size();
+            }
+            return n;
+        }
+
+        void clear() throw()
+        {
+            this->buffers.clear();
+            this->length = 0;
+        }
+
+        void swap(buffer_chain& that) throw()
+        {
+            this->buffers.swap(that.buffers);
+            std::swap(this->length, that.length);
+        }
+    };
+
+    inline void swap(buffer_chain& lhs, buffer_chain& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+}
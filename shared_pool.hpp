@@ -0,0 +1,475 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_mutex.hpp"
+#include "_ptr_element.hpp"
+#include "_ref_counted.hpp"
+#include "shared_ptr.hpp"
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <new>
+
+namespace ft
+{
+    namespace _internal
+    {
+        template <typename T>
+        struct pool_no_reset
+        {
+            void operator()(T&) const throw() {}
+        };
+
+        class _pool_state_base;
+
+        // control block of a pooled object, linked into a free list while cached
+        class _pool_block : public _counted_base
+        {
+        public:
+            _pool_block* next;
+            _pool_state_base* state;
+
+        public:
+            explicit _pool_block(_pool_state_base* state) throw()
+                : next(NULL), state(state) {}
+        };
+
+        // cached blocks of one pool on one thread
+        struct pool_list
+        {
+            _pool_state_base* pool;
+            _pool_block* head;
+            std::size_t depth;
+            pool_list* next;
+        };
+
+        // shared by every pool, freed when the last reference goes:
+        // the open pool, each block, live or cached, and each thread's list of it
+        class _pool_state_base
+        {
+        private:
+            long refs;
+            bool closed;
+#ifndef __GNUC__
+            mutex refs_lock;
+#endif
+
+            _pool_state_base(const _pool_state_base&);
+            _pool_state_base& operator=(const _pool_state_base&);
+
+        protected:
+            virtual ~_pool_state_base() {}
+
+        public:
+            _pool_state_base() throw()
+                : refs(1), closed(false) {}
+
+            // destroys the object of `block` and frees it, then drops its reference
+            virtual void free_block(_pool_block* block) throw() = 0;
+
+            void add_ref() throw()
+            {
+#ifdef __GNUC__
+                __atomic_add_fetch(&this->refs, 1, __ATOMIC_RELAXED);
+#else
+                mutex_guard guard(this->refs_lock);
+                ++this->refs;
+#endif
+            }
+
+            void release() throw()
+            {
+#ifdef __GNUC__
+                const bool release_this = __atomic_sub_fetch(&this->refs, 1, __ATOMIC_ACQ_REL) == 0;
+#else
+                bool release_this;
+                {
+                    mutex_guard guard(this->refs_lock);
+                    release_this = --this->refs == 0;
+                }
+#endif
+                if (release_this)
+                {
+                    delete this;
+                }
+            }
+
+            bool is_closed() const throw()
+            {
+#ifdef __GNUC__
+                return __atomic_load_n(&this->closed, __ATOMIC_ACQUIRE);
+#else
+                return this->closed;
+#endif
+            }
+
+            void set_closed() throw()
+            {
+#ifdef __GNUC__
+                __atomic_store_n(&this->closed, true, __ATOMIC_RELEASE);
+#else
+                this->closed = true;
+#endif
+            }
+        };
+
+        // free lists of the calling thread, one per pool it cached objects for.
+        // a single process wide key serves every pool. lists of closed pools are freed
+        // when the thread adds a list, or exits.
+        struct pool_cache
+        {
+            pool_list* lists;
+
+        public:
+            pool_cache() throw()
+                : lists(NULL) {}
+
+            // the list of `pool`, NULL if there is none and `create` is false or it can not be allocated
+            pool_list* find(_pool_state_base* pool, bool create) throw()
+            {
+                pool_list* list = this->lookup(pool);
+                if (list != NULL || !create)
+                {
+                    return list;
+                }
+
+                // destructors run by the sweep may use pools, look again after it
+                this->sweep();
+                list = this->lookup(pool);
+                if (list != NULL)
+                {
+                    return list;
+                }
+
+                list = ::new (std::nothrow) pool_list();
+                if (list != NULL)
+                {
+                    pool->add_ref();
+                    list->pool = pool;
+                    list->head = NULL;
+                    list->depth = 0;
+                    list->next = this->lists;
+                    this->lists = list;
+                }
+                return list;
+            }
+
+            // frees the list of `pool` and its blocks, if this thread has one
+            void remove(_pool_state_base* pool) throw()
+            {
+                pool_list* list = this->lookup(pool);
+                if (list != NULL)
+                {
+                    this->lists = list->next;
+                    free_list(list);
+                }
+            }
+
+            // NULL if there is none and `create` is false, or it can not be allocated
+            static pool_cache* current(bool create) throw()
+            {
+                if (!available())
+                {
+                    return NULL;
+                }
+
+                pool_cache* cache = static_cast<pool_cache*>(pthread_getspecific(key()));
+                if (cache == NULL && create)
+                {
+                    cache = ::new (std::nothrow) pool_cache();
+                    if (cache != NULL && pthread_setspecific(key(), cache) != 0)
+                    {
+                        ::delete cache;
+                        cache = NULL;
+                    }
+                }
+                return cache;
+            }
+
+            // false if the key could not be created
+            static bool available() throw()
+            {
+                static pthread_once_t once = PTHREAD_ONCE_INIT;
+                pthread_once(&once, &pool_cache::create_key);
+                return key_created();
+            }
+
+        private:
+            pool_list* lookup(const _pool_state_base* pool) throw()
+            {
+                for (pool_list** link = &this->lists; *link != NULL; link = &(*link)->next)
+                {
+                    pool_list* list = *link;
+                    if (list->pool == pool)
+                    {
+                        // most recently used first
+                        *link = list->next;
+                        list->next = this->lists;
+                        this->lists = list;
+                        return list;
+                    }
+                }
+                return NULL;
+            }
+
+            // frees the lists of closed pools, one at a time as their destructors may use pools
+            void sweep() throw()
+            {
+                for (;;)
+                {
+                    pool_list** link = &this->lists;
+                    while (*link != NULL && !(*link)->pool->is_closed())
+                    {
+                        link = &(*link)->next;
+                    }
+                    if (*link == NULL)
+                    {
+                        return;
+                    }
+
+                    pool_list* list = *link;
+                    *link = list->next;
+                    free_list(list);
+                }
+            }
+
+            static void free_list(pool_list* list) throw()
+            {
+                _pool_state_base* pool = list->pool;
+                _pool_block* head = list->head;
+                ::delete list;
+                while (head != NULL)
+                {
+                    _pool_block* next = head->next;
+                    pool->free_block(head);
+                    head = next;
+                }
+                pool->release();
+            }
+
+            static pthread_key_t& key() throw()
+            {
+                static pthread_key_t value;
+                return value;
+            }
+
+            static bool& key_created() throw()
+            {
+                static bool value = false;
+                return value;
+            }
+
+            static void create_key() throw()
+            {
+                key_created() = pthread_key_create(&key(), &pool_cache::thread_exit) == 0;
+            }
+
+            // objects released by the destructors run here go to a new cache,
+            // freed on the next round of thread exit destructors
+            static void thread_exit(void* p) throw()
+            {
+                pool_cache* cache = static_cast<pool_cache*>(p);
+                while (cache->lists != NULL)
+                {
+                    pool_list* list = cache->lists;
+                    cache->lists = list->next;
+                    free_list(list);
+                }
+                ::delete cache;
+            }
+        };
+
+        template <typename T, typename TReset>
+        class _pool_state;
+
+        // object and control block recycled together
+        template <typename T, typename TReset>
+        class _counted_impl_pool : public _pool_block
+        {
+        private:
+            typedef _internal::aligned_storage<sizeof(T), _internal::alignment_of<T>::value> storage_type;
+
+            typename storage_type::type data;
+
+            _counted_impl_pool(const _counted_impl_pool&);
+            _counted_impl_pool& operator=(const _counted_impl_pool&);
+
+        public:
+            explicit _counted_impl_pool(_pool_state<T, TReset>* state) throw()
+                : _pool_block(state) {}
+
+            void dispose() throw()
+            {
+                this->get_state()->reset_object(*this->get_pointer());
+            }
+
+            void destroy() throw()
+            {
+                this->get_state()->recycle(this);
+            }
+
+        public:
+            T* get_pointer() throw() { return static_cast<T*>(storage_type::address(this->data)); }
+            _pool_state<T, TReset>* get_state() const throw() { return static_cast<_pool_state<T, TReset>*>(this->state); }
+        };
+
+        template <typename T, typename TReset>
+        class _pool_state : public _pool_state_base
+        {
+        public:
+            typedef _counted_impl_pool<T, TReset> counted_type;
+
+        private:
+            TReset reset;
+            std::size_t max_cached;
+
+            _pool_state(const _pool_state&);
+            _pool_state& operator=(const _pool_state&);
+
+        public:
+            _pool_state(std::size_t max_cached, const TReset& reset)
+                : _pool_state_base(), reset(reset), max_cached(max_cached) {}
+
+            // lock free, a block cached by this thread or NULL
+            counted_type* pop() throw()
+            {
+                pool_cache* cache = pool_cache::current(false);
+                pool_list* list = cache == NULL ? NULL : cache->find(this, false);
+                if (list == NULL || list->head == NULL)
+                {
+                    return NULL;
+                }
+
+                counted_type* head = static_cast<counted_type*>(list->head);
+                list->head = head->next;
+                --list->depth;
+                head->revive();
+                return head;
+            }
+
+            counted_type* create()
+            {
+                counted_type* counted = ::new counted_type(this);
+                SMART_PTR_TRY
+                {
+                    ::new (counted->get_pointer()) T;
+                }
+                SMART_PTR_CATCH_ALL
+                {
+                    ::delete counted;
+                    SMART_PTR_RETHROW;
+                }
+
+                this->add_ref();
+                return counted;
+            }
+
+            void reset_object(T& object) throw()
+            {
+                this->reset(object);
+            }
+
+            // lock free, onto the list of this thread unless it is full or the pool is closed
+            void recycle(counted_type* counted) throw()
+            {
+                if (this->is_closed())
+                {
+                    pool_cache* cache = pool_cache::current(false);
+                    if (cache != NULL)
+                    {
+                        cache->remove(this);
+                    }
+                }
+                else
+                {
+                    pool_cache* cache = pool_cache::current(true);
+                    pool_list* list = cache == NULL ? NULL : cache->find(this, true);
+                    if (list != NULL && list->depth < this->max_cached)
+                    {
+                        counted->next = list->head;
+                        list->head = counted;
+                        ++list->depth;
+                        return;
+                    }
+                }
+                this->free_block(counted);
+            }
+
+            void free_block(_pool_block* block) throw()
+            {
+                counted_type* counted = static_cast<counted_type*>(block);
+                counted->get_pointer()->~T();
+                ::delete counted;
+                this->release();
+            }
+
+            // pool is gone: the objects cached by this thread are freed now, those cached by
+            // other threads when they next add a list or exit, those still acquired when
+            // they are released. the state lives on until then.
+            void close() throw()
+            {
+                this->set_closed();
+                pool_cache* cache = pool_cache::current(false);
+                if (cache != NULL)
+                {
+                    cache->remove(this);
+                }
+                this->release();
+            }
+        };
+    }
+
+    // hands out objects whose memory, constructed state and control block are reused.
+    // when the last reference drops, reset(object) runs and the object goes back to a
+    // free list owned by the releasing thread, up to max_cached objects per thread.
+    // acquiring and releasing a cached object take no lock.
+    // objects released after the pool is destroyed are freed right away.
+    // pooled objects are not hooked to enable_shared_from_this.
+    template <typename T, typename TReset = _internal::pool_no_reset<T> >
+    class shared_pool
+    {
+    public:
+        typedef T element_type;
+
+    private:
+        typedef _internal::_pool_state<T, TReset> state_type;
+        typedef typename state_type::counted_type counted_type;
+
+    private:
+        state_type* state;
+
+        shared_pool(const shared_pool&);
+        shared_pool& operator=(const shared_pool&);
+
+    public:
+        // throws std::bad_alloc if the thread specific key of the pools can not be created
+        explicit shared_pool(std::size_t max_cached = 64, const TReset& reset = TReset())
+            : state(NULL)
+        {
+            if (!_internal::pool_cache::available())
+            {
+                SMART_PTR_THROW(std::bad_alloc());
+            }
+            this->state = ::new state_type(max_cached, reset);
+        }
+
+        ~shared_pool()
+        {
+            this->state->close();
+        }
+
+        ft::shared_ptr<T> acquire()
+        {
+            counted_type* counted = this->state->pop();
+            if (counted == NULL)
+            {
+                counted = this->state->create();
+            }
+            return ft::shared_ptr<T>(_internal::adopt_tag(), counted->get_pointer(), counted);
+        }
+    };
+}
@@ -3,12 +3,16 @@
 
 #pragma once
 
+#include "_exception.hpp"
+#include "_hash.hpp"
 #include "_ptr_element.hpp"
 #include "_ref_counted.hpp"
+#include "unique_ptr.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <functional>
 
 namespace ft
 {
@@ -52,6 +56,21 @@ namespace ft
         element_type* ptr;
         counted_type ref;
 
+        // takes the pointer and deleter of `that` into a new control block, `that` keeps them if this throws
+        template <typename U, typename TDelete>
+        void adopt(unique_ptr<U, TDelete>& that)
+        {
+            _internal::assert_convertible<U, T>();
+
+            typename unique_ptr<U, TDelete>::pointer p = that.get();
+            if (p != NULL)
+            {
+                counted_type(_internal::internal_tag(), p, that.get_deleter()).swap(this->ref);
+                this->ptr = that.release();
+                _ptr_enable_shared_from_this<T>(this, p, p);
+            }
+        }
+
     public:
         shared_ptr() throw()
             : ptr(NULL), ref() {}
@@ -104,6 +123,31 @@ namespace ft
             this->ptr = that.ptr;
         }
 
+#if __cplusplus >= 201103L
+        template <typename U, typename TDelete>
+        shared_ptr(unique_ptr<U, TDelete>&& that)
+            : ptr(NULL), ref()
+        {
+            this->adopt(that);
+        }
+#else
+        // from a temporary
+        template <typename U, typename TDelete>
+        shared_ptr(unique_ptr<U, TDelete> that)
+            : ptr(NULL), ref()
+        {
+            this->adopt(that);
+        }
+
+        // from ft::move
+        template <typename U, typename TDelete>
+        shared_ptr(_internal::unique_ptr_ref<U, TDelete>& that)
+            : ptr(NULL), ref()
+        {
+            this->adopt(that);
+        }
+#endif
+
         // Internal BEGIN
         template <typename TStorage, typename TInitializer>
         shared_ptr(_internal::internal_tag, const TStorage& storage, TInitializer init)
@@ -111,6 +155,40 @@ namespace ft
         {
             _ptr_enable_shared_from_this<T>(this, this->ptr, this->ptr);
         }
+
+        // empty if expired
+        template <typename U>
+        shared_ptr(const weak_ptr<U>& that, _internal::nothrow_tag) throw()
+            : ptr(NULL), ref(that.ref, _internal::nothrow_tag())
+        {
+            _internal::assert_convertible<U, T>();
+
+            if (!this->ref.empty())
+            {
+                this->ptr = that.ptr;
+            }
+        }
+
+        // adopts a strong reference already taken on `counted`
+        shared_ptr(_internal::adopt_tag, element_type* p, _internal::_counted_base* counted) throw()
+            : ptr(p), ref(counted) {}
+
+        _internal::_counted_base* get_counted() const throw()
+        {
+            return this->ref.get_counted();
+        }
+
+        void init_shared_from_this() const throw()
+        {
+            _ptr_enable_shared_from_this<T>(this, this->ptr, this->ptr);
+        }
+
+        // becomes empty, the strong reference is left to the caller
+        _internal::_counted_base* detach() throw()
+        {
+            this->ptr = NULL;
+            return this->ref.detach();
+        }
         // Internal END
 
         ~shared_ptr() throw() {}
@@ -186,6 +264,35 @@ namespace ft
             return this->ref.use_count();
         }
 
+        template <typename U>
+        bool owner_before(const shared_ptr<U>& that) const throw()
+        {
+            return std::less<_internal::_counted_base*>()(this->get_counted(), that.get_counted());
+        }
+
+        template <typename U>
+        bool owner_before(const weak_ptr<U>& that) const throw()
+        {
+            return std::less<_internal::_counted_base*>()(this->get_counted(), that.get_counted());
+        }
+
+        template <typename U>
+        bool owner_equal(const shared_ptr<U>& that) const throw()
+        {
+            return this->get_counted() == that.get_counted();
+        }
+
+        template <typename U>
+        bool owner_equal(const weak_ptr<U>& that) const throw()
+        {
+            return this->get_counted() == that.get_counted();
+        }
+
+        std::size_t owner_hash() const throw()
+        {
+            return _internal::mix_hash(reinterpret_cast<std::size_t>(this->get_counted()));
+        }
+
         // explicit operator bool
         void unspecified_bool_type_func() const {}
         typedef void (shared_ptr::*unspecified_bool_type)() const;
@@ -199,6 +306,43 @@ namespace ft
             std::swap(this->ptr, that.ptr);
             this->ref.swap(that.ref);
         }
+
+        // assigns this to the `n` shared pointers from `first`, the count is raised once for all of them
+        template <typename TForwardIt>
+        TForwardIt share_n(TForwardIt first, std::size_t n) const
+        {
+            _internal::_counted_base* counted = this->get_counted();
+            if (counted == NULL)
+            {
+                for (; n != 0; --n, ++first)
+                {
+                    *first = *this;
+                }
+                return first;
+            }
+
+            if (n == 0)
+            {
+                return first;
+            }
+
+            counted->add_ref_copy(n);
+            SMART_PTR_TRY
+            {
+                for (; n != 0; --n, ++first)
+                {
+                    shared_ptr& slot = *first;
+                    shared_ptr(_internal::adopt_tag(), this->ptr, counted).swap(slot);
+                }
+            }
+            SMART_PTR_CATCH_ALL
+            {
+                // the iterator threw, the references not handed out yet are dropped
+                counted->release(n);
+                SMART_PTR_RETHROW;
+            }
+            return first;
+        }
     };
 
     template <typename T, typename U>
@@ -292,3 +436,17 @@ namespace ft
         return shared_ptr<T>(that, reinterpret_cast<typename shared_ptr<T>::element_type*>(that.get()));
     }
 }
+
+#if __cplusplus >= 201103L
+namespace std
+{
+    template <typename T>
+    struct hash<ft::shared_ptr<T> >
+    {
+        std::size_t operator()(const ft::shared_ptr<T>& p) const noexcept
+        {
+            return std::hash<typename ft::shared_ptr<T>::element_type*>()(p.get());
+        }
+    };
+}
+#endif
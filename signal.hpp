@@ -0,0 +1,467 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_mutex.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+#include "weak_ptr.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace ft
+{
+    namespace _internal
+    {
+        // slots of a signal: an immutable vector replaced as a whole on every change.
+        // writers build the next vector under `writer`, `lock` only guards the pointer to the
+        // current vector: emit() never waits for a copy, a slot call or a list being destroyed.
+        template <typename TInvoke>
+        class signal_slots
+        {
+        public:
+            struct slot
+            {
+                ft::weak_ptr<void> target;
+                TInvoke invoke;
+
+                slot(const ft::weak_ptr<void>& target, TInvoke invoke) throw()
+                    : target(target), invoke(invoke) {}
+            };
+
+            typedef std::vector<slot> list_type;
+
+        private:
+            mutable mutex lock;
+            mutex writer; // serialises connect, disconnect, prune and clear
+            ft::shared_ptr<const list_type> slots; // written under both mutexes
+
+            signal_slots(const signal_slots&);
+            signal_slots& operator=(const signal_slots&);
+
+        public:
+            signal_slots()
+                : lock(), writer(), slots() {}
+
+            ft::shared_ptr<const list_type> snapshot() const throw()
+            {
+                mutex_guard guard(this->lock);
+                return this->slots;
+            }
+
+            template <typename F>
+            void connect(const ft::shared_ptr<F>& target, TInvoke invoke)
+            {
+                mutex_guard guard(this->writer);
+                ft::shared_ptr<list_type> next = this->live_copy(1);
+                next->push_back(slot(ft::weak_ptr<void>(target), invoke));
+                this->exchange(next);
+            }
+
+            template <typename F>
+            void disconnect(const ft::shared_ptr<F>& target)
+            {
+                mutex_guard guard(this->writer);
+                ft::shared_ptr<list_type> next = this->live_copy(0);
+                for (typename list_type::iterator it = next->begin(); it != next->end();)
+                {
+                    it = target.owner_equal(it->target) ? next->erase(it) : it + 1;
+                }
+                this->exchange(next);
+            }
+
+            // drops every expired slot in one copy, skipped if another writer is busy
+            void prune(const list_type* seen)
+            {
+                if (!this->writer.try_lock())
+                {
+                    return;
+                }
+                SMART_PTR_TRY
+                {
+                    if (this->slots.get() == seen)
+                    {
+                        this->exchange(this->live_copy(0));
+                    }
+                }
+                SMART_PTR_CATCH_ALL
+                {
+                    this->writer.unlock();
+                    SMART_PTR_RETHROW;
+                }
+                this->writer.unlock();
+            }
+
+            void clear()
+            {
+                mutex_guard guard(this->writer);
+                this->exchange(ft::shared_ptr<const list_type>());
+            }
+
+        private:
+            // publishes `next` under `lock`, the previous list is released once it is unlocked
+            ft::shared_ptr<const list_type> exchange(const ft::shared_ptr<const list_type>& next) throw()
+            {
+                ft::shared_ptr<const list_type> previous = next;
+                {
+                    mutex_guard guard(this->lock);
+                    this->slots.swap(previous);
+                }
+                return previous;
+            }
+
+            // the live slots, with room for `extra` more
+            ft::shared_ptr<list_type> live_copy(std::size_t extra) const
+            {
+                ft::shared_ptr<list_type> next = ft::make_shared<list_type>();
+                if (this->slots)
+                {
+                    next->reserve(this->slots->size() + extra);
+                    for (typename list_type::const_iterator it = this->slots->begin(); it != this->slots->end(); ++it)
+                    {
+                        if (!it->target.expired())
+                        {
+                            next->push_back(*it);
+                        }
+                    }
+                }
+                return next;
+            }
+        };
+
+        template <typename TSlots>
+        std::size_t signal_size(const TSlots& slots)
+        {
+            ft::shared_ptr<const typename TSlots::list_type> list = slots.snapshot();
+            std::size_t n = 0;
+            if (list)
+            {
+                for (typename TSlots::list_type::const_iterator it = list->begin(); it != list->end(); ++it)
+                {
+                    n += it->target.expired() ? 0 : 1;
+                }
+            }
+            return n;
+        }
+    }
+
+    // observers held through weak_ptr: connecting does not keep a slot alive,
+    // a slot whose last shared_ptr is gone is skipped and later pruned.
+    // emit() runs over a snapshot of the slots without holding any lock,
+    // connect() and disconnect() copy the slot list, so emitting is never blocked by them
+    // for longer than a pointer swap.
+    // a slot is a shared_ptr<F> to a non-const callable F, invoked as (*f)(args...).
+    template <typename A1 = void, typename A2 = void, typename A3 = void>
+    class signal;
+
+    template <>
+    class signal<void, void, void>
+    {
+    private:
+        typedef void (*invoke_type)(void*);
+        typedef _internal::signal_slots<invoke_type> slots_type;
+
+        template <typename F>
+        static void invoke(void* f)
+        {
+            (*static_cast<F*>(f))();
+        }
+
+    private:
+        mutable slots_type slots; // emit() prunes expired slots
+
+        signal(const signal&);
+        signal& operator=(const signal&);
+
+    public:
+        signal()
+            : slots() {}
+
+        template <typename F>
+        void connect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.connect(target, &signal::invoke<F>);
+        }
+
+        template <typename F>
+        void disconnect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.disconnect(target);
+        }
+
+        void disconnect_all()
+        {
+            this->slots.clear();
+        }
+
+        // live slots
+        std::size_t size() const
+        {
+            return _internal::signal_size(this->slots);
+        }
+
+        void emit() const
+        {
+            const ft::shared_ptr<const slots_type::list_type> list = this->slots.snapshot();
+            if (!list)
+            {
+                return;
+            }
+
+            bool expired = false;
+            for (slots_type::list_type::const_iterator it = list->begin(); it != list->end(); ++it)
+            {
+                const ft::shared_ptr<void> target = it->target.lock();
+                if (!target)
+                {
+                    expired = true;
+                    continue;
+                }
+                it->invoke(target.get());
+            }
+            if (expired)
+            {
+                this->slots.prune(list.get());
+            }
+        }
+
+        void operator()() const
+        {
+            this->emit();
+        }
+    };
+
+    template <typename A1>
+    class signal<A1, void, void>
+    {
+    private:
+        typedef void (*invoke_type)(void*, A1);
+        typedef _internal::signal_slots<invoke_type> slots_type;
+
+        template <typename F>
+        static void invoke(void* f, A1 a1)
+        {
+            (*static_cast<F*>(f))(a1);
+        }
+
+    private:
+        mutable slots_type slots; // emit() prunes expired slots
+
+        signal(const signal&);
+        signal& operator=(const signal&);
+
+    public:
+        signal()
+            : slots() {}
+
+        template <typename F>
+        void connect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.connect(target, &signal::invoke<F>);
+        }
+
+        template <typename F>
+        void disconnect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.disconnect(target);
+        }
+
+        void disconnect_all()
+        {
+            this->slots.clear();
+        }
+
+        // live slots
+        std::size_t size() const
+        {
+            return _internal::signal_size(this->slots);
+        }
+
+        void emit(A1 a1) const
+        {
+            const ft::shared_ptr<const typename slots_type::list_type> list = this->slots.snapshot();
+            if (!list)
+            {
+                return;
+            }
+
+            bool expired = false;
+            for (typename slots_type::list_type::const_iterator it = list->begin(); it != list->end(); ++it)
+            {
+                const ft::shared_ptr<void> target = it->target.lock();
+                if (!target)
+                {
+                    expired = true;
+                    continue;
+                }
+                it->invoke(target.get(), a1);
+            }
+            if (expired)
+            {
+                this->slots.prune(list.get());
+            }
+        }
+
+        void operator()(A1 a1) const
+        {
+            this->emit(a1);
+        }
+    };
+
+    template <typename A1, typename A2>
+    class signal<A1, A2, void>
+    {
+    private:
+        typedef void (*invoke_type)(void*, A1, A2);
+        typedef _internal::signal_slots<invoke_type> slots_type;
+
+        template <typename F>
+        static void invoke(void* f, A1 a1, A2 a2)
+        {
+            (*static_cast<F*>(f))(a1, a2);
+        }
+
+    private:
+        mutable slots_type slots; // emit() prunes expired slots
+
+        signal(const signal&);
+        signal& operator=(const signal&);
+
+    public:
+        signal()
+            : slots() {}
+
+        template <typename F>
+        void connect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.connect(target, &signal::invoke<F>);
+        }
+
+        template <typename F>
+        void disconnect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.disconnect(target);
+        }
+
+        void disconnect_all()
+        {
+            this->slots.clear();
+        }
+
+        // live slots
+        std::size_t size() const
+        {
+            return _internal::signal_size(this->slots);
+        }
+
+        void emit(A1 a1, A2 a2) const
+        {
+            const ft::shared_ptr<const typename slots_type::list_type> list = this->slots.snapshot();
+            if (!list)
+            {
+                return;
+            }
+
+            bool expired = false;
+            for (typename slots_type::list_type::const_iterator it = list->begin(); it != list->end(); ++it)
+            {
+                const ft::shared_ptr<void> target = it->target.lock();
+                if (!target)
+                {
+                    expired = true;
+                    continue;
+                }
+                it->invoke(target.get(), a1, a2);
+            }
+            if (expired)
+            {
+                this->slots.prune(list.get());
+            }
+        }
+
+        void operator()(A1 a1, A2 a2) const
+        {
+            this->emit(a1, a2);
+        }
+    };
+
+    template <typename A1, typename A2, typename A3>
+    class signal
+    {
+    private:
+        typedef void (*invoke_type)(void*, A1, A2, A3);
+        typedef _internal::signal_slots<invoke_type> slots_type;
+
+        template <typename F>
+        static void invoke(void* f, A1 a1, A2 a2, A3 a3)
+        {
+            (*static_cast<F*>(f))(a1, a2, a3);
+        }
+
+    private:
+        mutable slots_type slots; // emit() prunes expired slots
+
+        signal(const signal&);
+        signal& operator=(const signal&);
+
+    public:
+        signal()
+            : slots() {}
+
+        template <typename F>
+        void connect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.connect(target, &signal::invoke<F>);
+        }
+
+        template <typename F>
+        void disconnect(const ft::shared_ptr<F>& target)
+        {
+            this->slots.disconnect(target);
+        }
+
+        void disconnect_all()
+        {
+            this->slots.clear();
+        }
+
+        // live slots
+        std::size_t size() const
+        {
+            return _internal::signal_size(this->slots);
+        }
+
+        void emit(A1 a1, A2 a2, A3 a3) const
+        {
+            const ft::shared_ptr<const typename slots_type::list_type> list = this->slots.snapshot();
+            if (!list)
+            {
+                return;
+            }
+
+            bool expired = false;
+            for (typename slots_type::list_type::const_iterator it = list->begin(); it != list->end(); ++it)
+            {
+                const ft::shared_ptr<void> target = it->target.lock();
+                if (!target)
+                {
+                    expired = true;
+                    continue;
+                }
+                it->invoke(target.get(), a1, a2, a3);
+            }
+            if (expired)
+            {
+                this->slots.prune(list.get());
+            }
+        }
+
+        void operator()(A1 a1, A2 a2, A3 a3) const
+        {
+            this->emit(a1, a2, a3);
+        }
+    };
+}
@@ -5,10 +5,46 @@
 
 #include "shared_ptr.hpp"
 
+#include "unique_ptr.hpp"
+
 #include "weak_ptr.hpp"
 
 #include "enable_shared_from_this.hpp"
 
 #include "make_shared.hpp"
 
+#include "make_shared_batch.hpp"
+
+#include "owner_less.hpp"
+
 #include "bad_weak_ptr.hpp"
+
+#include "compact_shared_ptr.hpp"
+
+#include "weak_cache.hpp"
+
+#include "shared_pool.hpp"
+
+#include "persistent_vector.hpp"
+
+#include "persistent_map.hpp"
+
+#include "cow_ptr.hpp"
+
+#include "numa_allocator.hpp"
+
+#include "huge_page_allocator.hpp"
+
+#include "arena.hpp"
+
+#include "map_shared.hpp"
+
+#include "shared_buffer.hpp"
+
+#include "release_all.hpp"
+
+#include "release_budget.hpp"
+
+#include "make_shared_collectable.hpp"
+
+#include "signal.hpp"
@@ -0,0 +1,22 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+// checks of the standalone tests in this directory, active with or without NDEBUG.
+// each test builds and runs on its own from the repository root:
+//
+//   g++ -std=c++98 -I. test/<name>.cpp -o <name> -lpthread && ./<name>
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(condition)                                                                         \
+    do                                                                                           \
+    {                                                                                            \
+        if (!(condition))                                                                        \
+        {                                                                                        \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::exit(1);                                                                        \
+        }                                                                                        \
+    } while (0)
@@ -0,0 +1,179 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    int live = 0;
+    int dead_reads = 0; // destructors that reached a sibling destroyed before them
+    int linked = 0;     // destructors that still found their traced pointer set
+
+    struct payload
+    {
+        static int count;
+
+        payload() { ++count; }
+        ~payload() { --count; }
+    };
+
+    int payload::count = 0;
+
+    struct node
+    {
+        int v;
+        ft::shared_ptr<node> next;
+        ft::weak_ptr<node> back;
+        ft::shared_ptr<payload> data;
+
+        explicit node(int v)
+            : v(v), next(), back(), data()
+        {
+            ++live;
+        }
+
+        ~node()
+        {
+            if (this->next)
+            {
+                ++linked;
+                if (this->next->v < 0)
+                {
+                    ++dead_reads;
+                }
+            }
+            this->v = -1;
+            --live;
+        }
+
+        void trace(ft::cycle_tracer& tracer) const
+        {
+            tracer(this->next);
+            tracer(this->back);
+            tracer(this->data);
+        }
+    };
+
+    void reset_counters()
+    {
+        dead_reads = 0;
+        linked = 0;
+    }
+
+    void test_two_node_cycle()
+    {
+        reset_counters();
+        {
+            ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+            ft::shared_ptr<node> b = ft::make_shared_collectable<node>(2);
+            a->next = b;
+            b->next = a;
+        }
+        CHECK(live == 2);
+        CHECK(ft::collect_cycles() == 2);
+        CHECK(live == 0);
+        CHECK(linked == 0 && dead_reads == 0);
+        CHECK(ft::collect_cycles() == 0);
+    }
+
+    void test_self_cycle()
+    {
+        reset_counters();
+        ft::weak_ptr<node> observer;
+        {
+            ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+            a->next = a;
+            observer = a;
+        }
+        CHECK(live == 1 && !observer.expired());
+        CHECK(ft::collect_cycles() == 1);
+        CHECK(live == 0 && observer.expired());
+        CHECK(linked == 0);
+    }
+
+    void test_reachable_cycle_is_kept()
+    {
+        reset_counters();
+        ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+        {
+            ft::shared_ptr<node> b = ft::make_shared_collectable<node>(2);
+            a->next = b;
+            b->next = a;
+        }
+        CHECK(ft::collect_cycles() == 0);
+        CHECK(live == 2 && a->next->next == a);
+
+        // the last outside reference is gone, the cycle goes with the next collection
+        a.reset();
+        CHECK(live == 2);
+        CHECK(ft::collect_cycles() == 2);
+        CHECK(live == 0 && dead_reads == 0);
+    }
+
+    void test_acyclic_objects_are_released_normally()
+    {
+        reset_counters();
+        {
+            ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+            a->next = ft::make_shared_collectable<node>(2);
+        }
+        CHECK(live == 0);
+        CHECK(ft::collect_cycles() == 0);
+    }
+
+    void test_weak_edges_do_not_keep_alive()
+    {
+        reset_counters();
+        {
+            ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+            ft::shared_ptr<node> b = ft::make_shared_collectable<node>(2);
+            a->next = b;
+            b->back = a;
+        }
+        CHECK(live == 0);
+        CHECK(ft::collect_cycles() == 0);
+    }
+
+    void test_cycle_releases_what_it_holds()
+    {
+        reset_counters();
+        ft::shared_ptr<node> outside = ft::make_shared_collectable<node>(10);
+        {
+            ft::shared_ptr<node> a = ft::make_shared_collectable<node>(1);
+            ft::shared_ptr<node> b = ft::make_shared_collectable<node>(2);
+            ft::shared_ptr<node> c = ft::make_shared_collectable<node>(3);
+            a->next = b;
+            b->next = c;
+            c->next = a;
+            a->data = ft::make_shared<payload>();
+            b->back = outside;
+
+            // a tail hanging off the cycle, only reachable through it
+            c->data = ft::make_shared<payload>();
+            outside->data = c->data;
+        }
+        CHECK(live == 4 && payload::count == 2);
+        CHECK(ft::collect_cycles() == 3);
+        CHECK(live == 1 && linked == 0 && dead_reads == 0);
+
+        // the payload shared with a live object stays
+        CHECK(payload::count == 1 && outside->data.use_count() == 1);
+        outside.reset();
+        CHECK(live == 0 && payload::count == 0);
+    }
+}
+
+int main()
+{
+    test_two_node_cycle();
+    test_self_cycle();
+    test_reachable_cycle_is_kept();
+    test_acyclic_objects_are_released_normally();
+    test_weak_edges_do_not_keep_alive();
+    test_cycle_releases_what_it_holds();
+    std::printf("collect_cycles: ok\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    struct pair
+    {
+        int first;
+        int second;
+
+        pair(int first, int second)
+            : first(first), second(second) {}
+    };
+
+    void test_round_trip()
+    {
+        ft::shared_ptr<pair> wide = ft::make_shared<pair>(1, 2);
+        ft::compact_shared_ptr<pair> compact(wide);
+        CHECK(sizeof(compact) == sizeof(void*));
+        CHECK(compact.get() == wide.get() && compact->second == 2);
+        CHECK(wide.use_count() == 2);
+
+        ft::shared_ptr<pair> back = compact;
+        CHECK(back == wide && back.use_count() == 3);
+
+        compact.reset();
+        back.reset();
+        CHECK(wide.unique());
+    }
+
+    void test_weak_round_trip()
+    {
+        ft::compact_weak_ptr<pair> weak;
+        {
+            ft::compact_shared_ptr<pair> owner(ft::make_shared<pair>(3, 4));
+            weak = owner;
+            CHECK(weak.lock().get() == owner.get());
+
+            ft::weak_ptr<pair> wide = weak;
+            CHECK(wide.lock().get() == owner.get());
+            ft::compact_weak_ptr<pair> again(wide);
+            CHECK(again.use_count() == 1);
+        }
+        CHECK(weak.expired() && !weak.lock());
+    }
+
+    bool throws_bad_weak_ptr(const ft::shared_ptr<int>& p)
+    {
+        try
+        {
+            ft::compact_shared_ptr<int> compact(p);
+        }
+        catch (const ft::bad_weak_ptr&)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    void test_rejects_what_it_can_not_hold()
+    {
+        ft::shared_ptr<pair> whole = ft::make_shared<pair>(5, 6);
+        ft::shared_ptr<int> aliased(whole, &whole->second);
+        CHECK(throws_bad_weak_ptr(aliased));
+        CHECK(whole.use_count() == 2);
+
+        // not created by make_shared
+        CHECK(throws_bad_weak_ptr(ft::shared_ptr<int>(new int(7))));
+
+        CHECK(!throws_bad_weak_ptr(ft::shared_ptr<int>()));
+        CHECK(!throws_bad_weak_ptr(ft::make_shared<int>(8)));
+    }
+}
+
+int main()
+{
+    test_round_trip();
+    test_weak_round_trip();
+    test_rejects_what_it_can_not_hold();
+    std::printf("compact_shared_ptr: ok\n");
+    return 0;
+}
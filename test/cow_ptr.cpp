@@ -0,0 +1,54 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    typedef std::vector<int> config;
+
+    void test_write_detaches_a_shared_value()
+    {
+        ft::cow_ptr<config> a(config(3, 1));
+        ft::cow_ptr<config> b = a;
+        CHECK(&a.read() == &b.read() && a.use_count() == 2);
+
+        b.write()[0] = 7;
+        CHECK(&a.read() != &b.read());
+        CHECK(a.read()[0] == 1 && b.read()[0] == 7 && b.read().size() == 3);
+        CHECK(a.unique() && b.unique());
+    }
+
+    void test_write_in_place_when_unique()
+    {
+        ft::cow_ptr<config> a(config(2, 5));
+        const config* before = &a.read();
+        a.write().push_back(6);
+        CHECK(&a.read() == before && a->size() == 3 && (*a)[2] == 6);
+    }
+
+    void test_handle_from_a_shared_ptr()
+    {
+        ft::shared_ptr<config> outside = ft::make_shared<config>(1, 9);
+        ft::cow_ptr<config> handle(outside);
+        CHECK(!handle.unique());
+
+        // the value seen through `outside` is not written
+        handle.write()[0] = 0;
+        CHECK((*outside)[0] == 9 && handle.read()[0] == 0);
+        CHECK(outside.unique());
+    }
+}
+
+int main()
+{
+    test_write_detaches_a_shared_value();
+    test_write_in_place_when_unique();
+    test_handle_from_a_shared_ptr();
+    std::printf("cow_ptr: ok\n");
+    return 0;
+}
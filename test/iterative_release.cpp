@@ -0,0 +1,107 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// SMART_PTR_ITERATIVE_RELEASE: long chains are released without recursion,
+// and a release_budget leaves the rest for drain_releases() or thread exit
+
+#define SMART_PTR_ITERATIVE_RELEASE
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <pthread.h>
+
+#include <cstdio>
+
+namespace
+{
+    struct node
+    {
+        static long live;
+
+        ft::shared_ptr<node> next;
+        ft::shared_ptr<node> other;
+
+        node() { ++live; }
+        ~node() { --live; }
+    };
+
+    long node::live = 0;
+
+    ft::shared_ptr<node> chain(long n)
+    {
+        ft::shared_ptr<node> head;
+        for (long i = 0; i < n; i++)
+        {
+            ft::shared_ptr<node> x = ft::make_shared<node>();
+            x->next = head;
+            head = x;
+        }
+        return head;
+    }
+
+    // recursive release of this chain overflows a default 8 MiB stack
+    void test_deep_chain()
+    {
+        ft::shared_ptr<node> head = chain(1000000);
+        CHECK(node::live == 1000000);
+        head.reset();
+        CHECK(node::live == 0);
+        CHECK(ft::pending_releases() == 0);
+    }
+
+    void test_budget_defers_the_rest()
+    {
+        ft::shared_ptr<node> head = chain(1000);
+        {
+            ft::release_budget budget(100);
+            head.reset();
+            CHECK(node::live == 900);
+            CHECK(ft::pending_releases() == 1);
+
+            CHECK(ft::drain_releases(50) == 1);
+            CHECK(node::live == 850);
+        }
+        CHECK(ft::drain_releases() == 0);
+        CHECK(node::live == 0);
+    }
+
+    void test_weak_references_into_a_chain()
+    {
+        ft::shared_ptr<node> root = chain(10);
+        root->other = chain(10);
+        ft::weak_ptr<node> w = root->other;
+        root.reset();
+        CHECK(node::live == 0);
+        CHECK(w.expired());
+    }
+
+    void* leave_work_behind(void*)
+    {
+        ft::shared_ptr<node> head = chain(1000);
+        {
+            ft::release_budget budget(10);
+            head.reset();
+        }
+        CHECK(ft::pending_releases() > 0);
+        return NULL;
+    }
+
+    void test_thread_exit_drains()
+    {
+        pthread_t thread;
+        CHECK(pthread_create(&thread, NULL, &leave_work_behind, NULL) == 0);
+        CHECK(pthread_join(thread, NULL) == 0);
+        CHECK(node::live == 0);
+    }
+}
+
+int main()
+{
+    test_deep_chain();
+    test_budget_defers_the_rest();
+    test_weak_references_into_a_chain();
+    test_thread_exit_drains();
+    std::printf("iterative_release: ok\n");
+    return 0;
+}
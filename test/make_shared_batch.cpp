@@ -0,0 +1,96 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    int live = 0;
+    int throw_at = -1; // construction that throws, -1 for none
+
+    struct item
+    {
+        int value;
+
+        explicit item(int value)
+            : value(value)
+        {
+            if (live == throw_at)
+            {
+                throw 1;
+            }
+            ++live;
+        }
+
+        ~item()
+        {
+            --live;
+        }
+    };
+
+    void test_batch_shares_one_block()
+    {
+        std::vector<ft::shared_ptr<item> > batch = ft::make_shared_batch<item>(8, 3);
+        CHECK(batch.size() == 8 && live == 8);
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            CHECK(batch[i]->value == 3 && batch[i].use_count() == 8);
+            CHECK(batch[i].owner_equal(batch[0]));
+        }
+        CHECK(batch[1].get() == batch[0].get() + 1);
+
+        // the objects all live until the last pointer is released
+        ft::shared_ptr<item> last = batch[7];
+        batch.clear();
+        CHECK(live == 8 && last.use_count() == 1);
+        last.reset();
+        CHECK(live == 0);
+
+        CHECK(ft::make_shared_batch<item>(0, 1).empty());
+    }
+
+    void test_batch_is_all_or_nothing()
+    {
+        throw_at = 5;
+        bool thrown = false;
+        try
+        {
+            ft::make_shared_batch<item>(8, 1);
+        }
+        catch (int)
+        {
+            thrown = true;
+        }
+        throw_at = -1;
+        CHECK(thrown && live == 0);
+    }
+
+    void test_group_members_share_one_block()
+    {
+        ft::shared_group<item, long> group = ft::make_shared_group<item, long>(4, 9L);
+        CHECK(group.first->value == 4 && *group.second == 9);
+        CHECK(group.first.owner_equal(group.second));
+        CHECK(group.first.use_count() == 2);
+
+        ft::shared_ptr<long> second = group.second;
+        group.first.reset();
+        group.second.reset();
+        CHECK(live == 1 && *second == 9);
+        second.reset();
+        CHECK(live == 0);
+    }
+}
+
+int main()
+{
+    test_batch_shares_one_block();
+    test_batch_is_all_or_nothing();
+    test_group_members_share_one_block();
+    std::printf("make_shared_batch: ok\n");
+    return 0;
+}
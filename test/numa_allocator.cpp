@@ -0,0 +1,81 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+// passes on machines with a single node or without NUMA support as well
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    struct large
+    {
+        unsigned char bytes[4096];
+    };
+
+    bool valid_node(int node)
+    {
+        return node == -1 || (node >= 0 && node < ft::numa_node_count());
+    }
+
+    void test_nodes()
+    {
+        CHECK(ft::numa_node_count() >= 1);
+        CHECK(ft::numa_current_node() >= 0 && ft::numa_current_node() < ft::numa_node_count());
+        CHECK(ft::numa_node_of(ft::shared_ptr<int>()) == -1);
+
+        // an out of range node falls back to node 0
+        CHECK(ft::numa_allocator<int>(-1).node() == 0);
+        CHECK(ft::numa_allocator<int>(1 << 20).node() == 0);
+        CHECK(ft::numa_allocator<int>(0) == ft::numa_allocator<long>(0));
+    }
+
+    void test_allocate_shared_on_a_node()
+    {
+        ft::shared_ptr<long> given = ft::allocate_shared<long>(ft::numa_allocator<long>(0), 42L);
+        CHECK(*given == 42 && given.unique());
+        CHECK(valid_node(ft::numa_node_of(given)));
+
+        ft::shared_ptr<long> current = ft::allocate_shared<long>(ft::numa_allocator<long>(), 7L);
+        CHECK(*current == 7);
+        CHECK(valid_node(ft::numa_node_of(current)));
+
+        // small blocks of one size are reused
+        const void* block = given.get_counted();
+        given.reset();
+        ft::shared_ptr<long> again = ft::allocate_shared<long>(ft::numa_allocator<long>(0), 1L);
+        CHECK(again.get_counted() == block);
+    }
+
+    void test_large_blocks_are_mapped()
+    {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+        ft::shared_ptr<large> p = ft::allocate_shared<large>(ft::numa_allocator<large>(0));
+        CHECK(reinterpret_cast<std::size_t>(p.get_counted()) % page == 0);
+        std::memset(p->bytes, 0xab, sizeof(p->bytes));
+        CHECK(p->bytes[0] == 0xab && p->bytes[sizeof(p->bytes) - 1] == 0xab);
+        CHECK(valid_node(ft::numa_node_of(p)));
+
+        ft::numa_allocator<large> alloc(0);
+        large* many = alloc.allocate(3);
+        CHECK(reinterpret_cast<std::size_t>(many) % page == 0);
+        std::memset(many, 0, 3 * sizeof(large));
+        alloc.deallocate(many, 3);
+    }
+}
+
+int main()
+{
+    test_nodes();
+    test_allocate_shared_on_a_node();
+    test_large_blocks_are_mapped();
+    std::printf("numa_allocator: ok (%d node(s))\n", ft::numa_node_count());
+    return 0;
+}
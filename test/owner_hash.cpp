@@ -0,0 +1,80 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace
+{
+    struct pair
+    {
+        int first;
+        int second;
+    };
+
+    void test_aliases_share_an_owner()
+    {
+        ft::shared_ptr<pair> whole = ft::make_shared<pair>();
+        ft::shared_ptr<int> part(whole, &whole->second);
+        ft::weak_ptr<pair> weak = whole;
+
+        CHECK(whole.owner_equal(part) && part.owner_equal(weak));
+        CHECK(!whole.owner_before(part) && !part.owner_before(whole));
+        CHECK(whole.owner_hash() == part.owner_hash());
+        CHECK(weak.owner_hash() == whole.owner_hash());
+        CHECK(ft::owner_hash()(part) == ft::owner_hash()(weak));
+        CHECK(ft::owner_equal()(part, weak));
+
+        // an expired weak_ptr keeps its owner
+        const std::size_t hash = whole.owner_hash();
+        whole.reset();
+        part.reset();
+        CHECK(weak.expired() && weak.owner_hash() == hash);
+    }
+
+    void test_distinct_owners()
+    {
+        ft::shared_ptr<int> a = ft::make_shared<int>(1);
+        ft::shared_ptr<int> b = ft::make_shared<int>(1);
+        CHECK(!a.owner_equal(b));
+        CHECK(a.owner_before(b) != b.owner_before(a));
+
+        std::map<ft::shared_ptr<int>, int, ft::owner_less<ft::shared_ptr<int> > > by_owner;
+        by_owner[a] = 1;
+        by_owner[b] = 2;
+        by_owner[ft::shared_ptr<int>(a, a.get())] = 3;
+        CHECK(by_owner.size() == 2 && by_owner[a] == 3);
+    }
+
+    void test_hash_spreads_low_bits()
+    {
+        // control blocks are aligned, the unmixed addresses would all land in one of 16 buckets
+        std::vector<ft::shared_ptr<int> > keys;
+        bool used[16] = {false};
+        for (int i = 0; i < 256; i++)
+        {
+            keys.push_back(ft::make_shared<int>(i));
+            used[keys.back().owner_hash() % 16] = true;
+        }
+        std::size_t buckets = 0;
+        for (std::size_t i = 0; i < 16; i++)
+        {
+            buckets += used[i] ? 1 : 0;
+        }
+        CHECK(buckets > 8);
+    }
+}
+
+int main()
+{
+    test_aliases_share_an_owner();
+    test_distinct_owners();
+    test_hash_spreads_low_bits();
+    std::printf("owner_hash: ok\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+
+namespace
+{
+    const std::size_t element_count = 2000; // three trie levels
+
+    void test_vector_snapshots_are_untouched()
+    {
+        ft::persistent_vector<long> v;
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            v.push_back(static_cast<long>(i));
+        }
+
+        ft::persistent_vector<long> snapshot = v;
+        v.set(0, -1);
+        v.set(1500, -2);
+        v.push_back(-3);
+        CHECK(v.size() == element_count + 1 && v[0] == -1 && v[1500] == -2 && v.back() == -3);
+
+        CHECK(snapshot.size() == element_count);
+        for (std::size_t i = 0; i < element_count; i++)
+        {
+            CHECK(snapshot[i] == static_cast<long>(i));
+        }
+
+        while (!v.empty())
+        {
+            v.pop_back();
+        }
+        CHECK(snapshot.size() == element_count && snapshot.back() == static_cast<long>(element_count - 1));
+    }
+
+    void test_map_snapshots_are_untouched()
+    {
+        ft::persistent_map<long, long> m;
+        for (long k = 0; k < static_cast<long>(element_count); k++)
+        {
+            CHECK(m.set(k, k * 2));
+        }
+
+        ft::persistent_map<long, long> snapshot = m;
+        CHECK(!m.set(10, -1));
+        CHECK(m.erase(11) && !m.erase(11));
+        CHECK(m.set(-5, 5));
+        CHECK(m.size() == element_count && *m.find(10) == -1 && !m.contains(11) && *m.find(-5) == 5);
+
+        CHECK(snapshot.size() == element_count && !snapshot.contains(-5));
+        for (long k = 0; k < static_cast<long>(element_count); k++)
+        {
+            const long* value = snapshot.find(k);
+            CHECK(value != NULL && *value == k * 2);
+        }
+    }
+
+    struct one_hash
+    {
+        std::size_t operator()(long) const { return 42; }
+    };
+
+    void test_map_collisions()
+    {
+        ft::persistent_map<long, long, one_hash> m;
+        for (long k = 0; k < 10; k++)
+        {
+            m.set(k, k);
+        }
+        ft::persistent_map<long, long, one_hash> snapshot = m;
+        m.erase(3);
+        m.set(4, 40);
+        CHECK(m.size() == 9 && !m.contains(3) && *m.find(4) == 40);
+        CHECK(snapshot.size() == 10 && *snapshot.find(3) == 3 && *snapshot.find(4) == 4);
+    }
+}
+
+int main()
+{
+    test_vector_snapshots_are_untouched();
+    test_map_snapshots_are_untouched();
+    test_map_collisions();
+    std::printf("persistent: ok\n");
+    return 0;
+}
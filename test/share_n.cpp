@@ -0,0 +1,115 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <list>
+#include <vector>
+
+namespace
+{
+    struct tracked
+    {
+        static int alive;
+
+        tracked() { ++alive; }
+        ~tracked() { --alive; }
+    };
+
+    int tracked::alive = 0;
+
+    void test_share_n_counts()
+    {
+        ft::shared_ptr<tracked> p = ft::make_shared<tracked>();
+        std::vector<ft::shared_ptr<tracked> > copies(5);
+
+        std::vector<ft::shared_ptr<tracked> >::iterator end = p.share_n(copies.begin(), 5);
+        CHECK(end == copies.end());
+        CHECK(p.use_count() == 6);
+        for (std::size_t i = 0; i < copies.size(); i++)
+        {
+            CHECK(copies[i] == p && copies[i].owner_equal(p));
+        }
+
+        // slots already holding the pointer are released as they are overwritten
+        p.share_n(copies.begin(), 3);
+        CHECK(p.use_count() == 6);
+
+        CHECK(p.share_n(copies.begin(), 0) == copies.begin());
+        CHECK(p.use_count() == 6);
+    }
+
+    void test_share_n_replaces_other_owners()
+    {
+        ft::shared_ptr<tracked> first = ft::make_shared<tracked>();
+        ft::weak_ptr<tracked> weak = first;
+        std::list<ft::shared_ptr<tracked> > slots(3, first);
+        CHECK(first.use_count() == 4);
+        first.reset();
+
+        ft::shared_ptr<tracked> second = ft::make_shared<tracked>();
+        second.share_n(slots.begin(), slots.size());
+        CHECK(weak.expired() && tracked::alive == 1);
+        CHECK(second.use_count() == 4);
+    }
+
+    void test_share_n_of_an_empty_pointer()
+    {
+        ft::shared_ptr<tracked> p = ft::make_shared<tracked>();
+        std::vector<ft::shared_ptr<tracked> > copies(3, p);
+        CHECK(p.use_count() == 4);
+
+        ft::shared_ptr<tracked>().share_n(copies.begin(), copies.size());
+        CHECK(p.use_count() == 1);
+        for (std::size_t i = 0; i < copies.size(); i++)
+        {
+            CHECK(!copies[i]);
+        }
+    }
+
+    void test_release_all_counts()
+    {
+        ft::shared_ptr<tracked> a = ft::make_shared<tracked>();
+        ft::shared_ptr<tracked> b = ft::make_shared<tracked>();
+        ft::weak_ptr<tracked> weak_a = a;
+        ft::weak_ptr<tracked> weak_b = b;
+
+        std::vector<ft::shared_ptr<tracked> > all(7);
+        a.share_n(all.begin(), 4);
+        b.share_n(all.begin() + 4, 2);
+        CHECK(a.use_count() == 5 && b.use_count() == 3 && !all[6]);
+
+        ft::release_all(all.begin(), all.end());
+        for (std::size_t i = 0; i < all.size(); i++)
+        {
+            CHECK(!all[i] && all[i].use_count() == 0);
+        }
+        CHECK(a.use_count() == 1 && b.use_count() == 1);
+
+        // the last references go with release_all
+        a.share_n(all.begin(), 3);
+        b.share_n(all.begin() + 3, 3);
+        a.reset();
+        b.reset();
+        CHECK(tracked::alive == 2);
+        ft::release_all(all.begin(), all.end());
+        CHECK(weak_a.expired() && weak_b.expired() && tracked::alive == 0);
+
+        ft::release_all(all.begin(), all.begin());
+        ft::release_all(all.begin(), all.end());
+    }
+}
+
+int main()
+{
+    test_share_n_counts();
+    test_share_n_replaces_other_owners();
+    test_share_n_of_an_empty_pointer();
+    test_release_all_counts();
+    CHECK(tracked::alive == 0);
+    std::printf("share_n: ok\n");
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <sys/uio.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    ft::shared_buffer text(const char* s)
+    {
+        return ft::shared_buffer(s, std::strlen(s));
+    }
+
+    bool equals(const ft::shared_buffer& b, const char* s)
+    {
+        return b.size() == std::strlen(s) && std::memcmp(b.data(), s, b.size()) == 0;
+    }
+
+    void test_slices_share_until_written()
+    {
+        ft::shared_buffer whole = text("hello world");
+        ft::shared_buffer word = whole.slice(6, 5);
+        CHECK(equals(word, "world"));
+        CHECK(word.data() == whole.data() + 6);
+
+        word.mutable_data()[0] = 'W';
+        CHECK(equals(word, "World"));
+        CHECK(equals(whole, "hello world"));
+
+        // the only owner writes in place
+        ft::shared_buffer alone = text("abc");
+        const unsigned char* before = alone.data();
+        alone.mutable_data()[0] = 'A';
+        CHECK(alone.data() == before && equals(alone, "Abc"));
+    }
+
+    // bytes of a read only mapping are copied before any write, even by their only owner
+    void test_borrowed_bytes_are_copied()
+    {
+        const char* path = "/tmp/smart_ptr_test_shared_buffer.bin";
+        FILE* f = std::fopen(path, "wb");
+        CHECK(f != NULL);
+        std::fputs("mapped!!", f);
+        std::fclose(f);
+
+        ft::shared_buffer b;
+        {
+            ft::shared_ptr<const char[]> map = ft::map_shared<const char[]>(path, 0, 8);
+            CHECK(map);
+            b = ft::shared_buffer(map, map.get(), 8);
+        }
+        CHECK(b.unique());
+        const unsigned char* mapped = b.data();
+        b.mutable_data()[0] = 'X';
+        CHECK(b.data() != mapped && equals(b, "Xapped!!"));
+
+        std::remove(path);
+    }
+
+    void test_chain_split_and_consume()
+    {
+        ft::buffer_chain chain;
+        chain.append(text("abc"));
+        chain.append(text("defg"));
+        chain.prepend(text("01"));
+        CHECK(chain.size() == 9 && chain.buffer_count() == 3);
+
+        ft::buffer_chain head = chain.split(4);
+        CHECK(equals(head.coalesce(), "01ab"));
+        CHECK(equals(chain.coalesce(), "cdefg"));
+
+        chain.consume(2);
+        CHECK(equals(chain.coalesce(), "efg") && chain.buffer_count() == 1);
+
+        struct iovec iov[4];
+        CHECK(head.to_iovec(iov, 4) == 2);
+        CHECK(iov[0].iov_len == 2 && iov[1].iov_len == 2);
+    }
+
+    void test_chain_appends_itself()
+    {
+        ft::buffer_chain chain;
+        chain.append(text("ab"));
+        chain.append(text("cd"));
+        chain.append(chain);
+        CHECK(chain.size() == 8 && equals(chain.coalesce(), "abcdabcd"));
+
+        chain.prepend(chain);
+        CHECK(chain.size() == 16 && chain.buffer_count() == 8);
+        CHECK(equals(chain.coalesce(), "abcdabcdabcdabcd"));
+    }
+}
+
+int main()
+{
+    test_slices_share_until_written();
+    test_borrowed_bytes_are_copied();
+    test_chain_split_and_consume();
+    test_chain_appends_itself();
+    std::printf("shared_buffer: ok\n");
+    return 0;
+}
@@ -0,0 +1,136 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <cstdio>
+
+namespace
+{
+    struct connection : ft::enable_shared_from_this<connection>
+    {
+        int id;
+
+        explicit connection(int id)
+            : id(id) {}
+    };
+
+    struct no_delete
+    {
+        void operator()(connection*) const throw() {}
+    };
+
+    void test_shares_the_owner()
+    {
+        ft::shared_ptr<connection> owner = ft::make_shared<connection>(1);
+        ft::shared_ptr<connection> self = owner->shared_from_this();
+        CHECK(self == owner && owner.use_count() == 2);
+
+        const connection& view = *owner;
+        ft::shared_ptr<const connection> const_self = view.shared_from_this();
+        CHECK(const_self.get() == owner.get() && owner.use_count() == 3);
+
+        ft::weak_ptr<connection> weak = owner->weak_from_this();
+        CHECK(weak.lock() == owner);
+
+        self.reset();
+        const_self.reset();
+        owner.reset();
+        CHECK(weak.expired());
+    }
+
+    void test_without_an_owner()
+    {
+        connection unowned(2);
+        bool threw = false;
+        try
+        {
+            unowned.shared_from_this();
+        }
+        catch (const ft::bad_weak_ptr&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(unowned.weak_from_this().expired());
+    }
+
+    // the first owner expired without destroying the object, a later one takes over
+    void test_after_the_owner_expired()
+    {
+        connection* raw = new connection(3);
+        {
+            ft::shared_ptr<connection> first(raw, no_delete());
+            CHECK(raw->shared_from_this().owner_equal(first));
+        }
+
+        bool threw = false;
+        try
+        {
+            raw->shared_from_this();
+        }
+        catch (const ft::bad_weak_ptr&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(raw->weak_from_this().expired());
+
+        ft::shared_ptr<connection> second(raw);
+        ft::shared_ptr<connection> self = raw->shared_from_this();
+        CHECK(self.owner_equal(second) && second.use_count() == 2);
+        CHECK(!raw->weak_from_this().expired());
+    }
+
+    // a live owner is kept, a second one of the same object does not replace it
+    void test_first_owner_wins()
+    {
+        ft::shared_ptr<connection> first = ft::make_shared<connection>(4);
+        ft::shared_ptr<connection> second(first.get(), no_delete());
+        CHECK(second->shared_from_this().owner_equal(first));
+    }
+
+    // each round gives every object of this thread a new owner after the previous one expired
+    void* replace_owners(void*)
+    {
+        connection objects[] = {connection(0), connection(1), connection(2), connection(3)};
+        for (int round = 0; round < 2000; round++)
+        {
+            for (std::size_t i = 0; i < sizeof(objects) / sizeof(objects[0]); i++)
+            {
+                ft::shared_ptr<connection> owner(&objects[i], no_delete());
+                ft::shared_ptr<connection> self = objects[i].shared_from_this();
+                CHECK(self.owner_equal(owner) && self->id == static_cast<int>(i));
+            }
+        }
+        return NULL;
+    }
+
+    void test_concurrent_new_owners()
+    {
+        pthread_t threads[4];
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            pthread_create(&threads[i], NULL, &replace_owners, NULL);
+        }
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+int main()
+{
+    test_shares_the_owner();
+    test_without_an_owner();
+    test_after_the_owner_expired();
+    test_first_owner_wins();
+    test_concurrent_new_owners();
+    std::printf("shared_from_this: ok\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    int constructed = 0;
+    int destroyed = 0;
+    int resets = 0;
+
+    struct connection
+    {
+        int requests;
+
+        connection()
+            : requests(0)
+        {
+            ++constructed;
+        }
+
+        ~connection()
+        {
+            ++destroyed;
+        }
+    };
+
+    struct clear_requests
+    {
+        void operator()(connection& c) const
+        {
+            c.requests = 0;
+            ++resets;
+        }
+    };
+
+    typedef ft::shared_pool<connection, clear_requests> pool_type;
+
+    void reset_counters()
+    {
+        constructed = 0;
+        destroyed = 0;
+        resets = 0;
+    }
+
+    void test_released_objects_are_reset_and_reused()
+    {
+        reset_counters();
+        {
+            pool_type pool;
+            ft::weak_ptr<connection> weak;
+            connection* first = NULL;
+            {
+                ft::shared_ptr<connection> c = pool.acquire();
+                first = c.get();
+                c->requests = 5;
+                weak = c;
+            }
+            CHECK(resets == 1 && destroyed == 0);
+
+            // the block goes back to the pool once no weak_ptr refers to it either
+            CHECK(weak.expired());
+            weak.reset();
+
+            ft::shared_ptr<connection> again = pool.acquire();
+            CHECK(again.get() == first && again->requests == 0);
+            CHECK(again.use_count() == 1 && constructed == 1);
+        }
+        CHECK(destroyed == 1);
+    }
+
+    void test_max_cached_bounds_the_free_list()
+    {
+        reset_counters();
+        {
+            pool_type pool(2);
+            {
+                ft::shared_ptr<connection> held[4];
+                for (int i = 0; i < 4; i++)
+                {
+                    held[i] = pool.acquire();
+                }
+                CHECK(constructed == 4);
+            }
+            // two cached, the other two freed
+            CHECK(resets == 4 && destroyed == 2);
+
+            ft::shared_ptr<connection> held[3];
+            for (int i = 0; i < 3; i++)
+            {
+                held[i] = pool.acquire();
+            }
+            CHECK(constructed == 5);
+        }
+        CHECK(destroyed == 5);
+    }
+
+    void test_objects_outlive_their_pool()
+    {
+        reset_counters();
+        ft::shared_ptr<connection> survivor;
+        {
+            pool_type pool;
+            survivor = pool.acquire();
+            survivor->requests = 3;
+        }
+        CHECK(destroyed == 0 && survivor->requests == 3);
+        survivor.reset();
+        CHECK(destroyed == 1);
+    }
+}
+
+int main()
+{
+    test_released_objects_are_reset_and_reused();
+    test_max_cached_bounds_the_free_list();
+    test_objects_outlive_their_pool();
+    std::printf("shared_pool: ok\n");
+    return 0;
+}
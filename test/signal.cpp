@@ -0,0 +1,196 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    // control blocks given back, an expired slot keeps its block until it is pruned
+    int blocks_freed = 0;
+
+    template <typename T>
+    class counting_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() throw() {}
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U>&) throw() {}
+
+        T* allocate(std::size_t n, const void* = NULL)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) throw()
+        {
+            ++blocks_freed;
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        std::size_t max_size() const throw() { return static_cast<std::size_t>(-1) / sizeof(T); }
+
+        void construct(T* p, const T& value) { ::new (static_cast<void*>(p)) T(value); }
+        void destroy(T* p) { p->~T(); }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) throw() { return true; }
+
+    template <typename T, typename U>
+    bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) throw() { return false; }
+
+    struct counter
+    {
+        int calls;
+        int sum;
+
+        counter()
+            : calls(0), sum(0) {}
+
+        void operator()()
+        {
+            ++this->calls;
+        }
+
+        void operator()(int a)
+        {
+            ++this->calls;
+            this->sum += a;
+        }
+
+        void operator()(int a, int b, int c)
+        {
+            ++this->calls;
+            this->sum += a + b + c;
+        }
+    };
+
+    ft::shared_ptr<counter> make_counter()
+    {
+        return ft::allocate_shared<counter>(counting_allocator<counter>());
+    }
+
+    void test_connect_and_emit()
+    {
+        ft::signal<> ping;
+        CHECK(ping.size() == 0);
+        ping.emit();
+
+        ft::shared_ptr<counter> a = make_counter();
+        ft::shared_ptr<counter> b = make_counter();
+        ping.connect(a);
+        ping.connect(b);
+        CHECK(ping.size() == 2);
+        CHECK(a.use_count() == 1);
+
+        ping.emit();
+        ping();
+        CHECK(a->calls == 2 && b->calls == 2);
+
+        ft::signal<int> value;
+        value.connect(a);
+        value.emit(5);
+        value(7);
+        CHECK(a->calls == 4 && a->sum == 12);
+
+        ft::signal<int, int, int> triple;
+        triple.connect(b);
+        triple.emit(1, 2, 3);
+        CHECK(b->calls == 3 && b->sum == 6);
+    }
+
+    void test_disconnect()
+    {
+        ft::signal<> ping;
+        ft::shared_ptr<counter> a = make_counter();
+        ft::shared_ptr<counter> b = make_counter();
+        ping.connect(a);
+        ping.connect(b);
+        ping.connect(a);
+        CHECK(ping.size() == 3);
+
+        // every slot of the target goes
+        ping.disconnect(a);
+        CHECK(ping.size() == 1);
+        ping.emit();
+        CHECK(a->calls == 0 && b->calls == 1);
+
+        // not connected, nothing changes
+        ping.disconnect(a);
+        CHECK(ping.size() == 1);
+
+        ping.disconnect_all();
+        CHECK(ping.size() == 0);
+        ping.emit();
+        CHECK(b->calls == 1);
+    }
+
+    void test_expired_slots_are_skipped_and_pruned()
+    {
+        ft::signal<int> value;
+        ft::shared_ptr<counter> kept = make_counter();
+        ft::shared_ptr<counter> dropped = make_counter();
+        value.connect(dropped);
+        value.connect(kept);
+        CHECK(value.size() == 2);
+
+        const int freed = blocks_freed;
+        dropped.reset();
+        CHECK(value.size() == 1);
+        CHECK(blocks_freed == freed);
+
+        // the emit that finds the slot expired skips it and drops it
+        value.emit(1);
+        CHECK(kept->calls == 1 && value.size() == 1);
+        CHECK(blocks_freed == freed + 1);
+
+        value.emit(2);
+        CHECK(kept->calls == 2 && kept->sum == 3);
+    }
+
+    void test_writers_prune_too()
+    {
+        ft::signal<> ping;
+        ft::shared_ptr<counter> dropped = make_counter();
+        ping.connect(dropped);
+
+        const int freed = blocks_freed;
+        dropped.reset();
+        CHECK(blocks_freed == freed);
+
+        ft::shared_ptr<counter> next = make_counter();
+        ping.connect(next);
+        CHECK(blocks_freed == freed + 1);
+        CHECK(ping.size() == 1);
+    }
+}
+
+int main()
+{
+    test_connect_and_emit();
+    test_disconnect();
+    test_expired_slots_are_skipped_and_pruned();
+    test_writers_prune_too();
+    std::printf("signal: ok\n");
+    return 0;
+}
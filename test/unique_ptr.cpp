@@ -0,0 +1,87 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    int deletes = 0;
+
+    struct base
+    {
+        virtual ~base() {}
+    };
+
+    struct widget : base, ft::enable_shared_from_this<widget>
+    {
+        int value;
+
+        explicit widget(int value)
+            : value(value) {}
+    };
+
+    struct counting_delete
+    {
+        void operator()(widget* p) const
+        {
+            ++deletes;
+            delete p;
+        }
+    };
+
+    void test_moves()
+    {
+        ft::unique_ptr<widget> a = ft::make_unique<widget>(1);
+        CHECK(sizeof(a) == sizeof(widget*));
+
+        ft::unique_ptr<widget> b(ft::move(a));
+        CHECK(!a && b->value == 1);
+
+        ft::unique_ptr<base> c(ft::move(b));
+        CHECK(!b && c);
+
+        widget* raw = new widget(2);
+        ft::unique_ptr<widget> d(raw);
+        CHECK(d.release() == raw && !d);
+        delete raw;
+    }
+
+    void test_promotion_keeps_the_deleter()
+    {
+        deletes = 0;
+        ft::unique_ptr<widget, counting_delete> owner(new widget(3), counting_delete());
+        ft::shared_ptr<widget> shared(ft::move(owner));
+        CHECK(!owner && shared->value == 3 && shared.unique());
+
+        ft::shared_ptr<widget> copy = shared;
+        shared.reset();
+        CHECK(deletes == 0);
+        copy.reset();
+        CHECK(deletes == 1);
+    }
+
+    void test_promotion_hooks_shared_from_this()
+    {
+        ft::shared_ptr<widget> shared(ft::make_unique<widget>(4));
+        CHECK(shared.unique());
+        ft::shared_ptr<widget> self = shared->shared_from_this();
+        CHECK(self == shared && shared.use_count() == 2);
+
+        // an empty unique_ptr promotes to an empty shared_ptr
+        ft::unique_ptr<base> empty;
+        ft::shared_ptr<base> none(ft::move(empty));
+        CHECK(!none && none.use_count() == 0);
+    }
+}
+
+int main()
+{
+    test_moves();
+    test_promotion_keeps_the_deleter();
+    test_promotion_hooks_shared_from_this();
+    std::printf("unique_ptr: ok\n");
+    return 0;
+}
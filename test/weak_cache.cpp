@@ -0,0 +1,97 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#include "check.hpp"
+#include "smart_ptr.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    struct value
+    {
+        static int live;
+
+        long key;
+
+        explicit value(long key)
+            : key(key)
+        {
+            ++live;
+        }
+
+        ~value()
+        {
+            --live;
+        }
+    };
+
+    int value::live = 0;
+
+    void test_hit_returns_the_live_object()
+    {
+        ft::weak_cache<long, value> cache;
+        ft::shared_ptr<value> a = cache.get(1);
+        ft::shared_ptr<value> b = cache.get(1);
+        CHECK(a == b && a->key == 1 && value::live == 1);
+        CHECK(cache.find(1) == a && !cache.find(2));
+        CHECK(cache.size() == 1);
+    }
+
+    void test_last_release_evicts()
+    {
+        ft::weak_cache<long, value> cache;
+        ft::shared_ptr<value> a = cache.get(7);
+        ft::shared_ptr<value> copy = a;
+        ft::weak_ptr<value> weak = a;
+
+        a.reset();
+        CHECK(cache.size() == 1 && value::live == 1);
+
+        copy.reset();
+        CHECK(cache.empty() && value::live == 0 && weak.expired());
+        CHECK(!cache.find(7));
+
+        // a miss builds a new object
+        ft::shared_ptr<value> again = cache.get(7);
+        CHECK(again && value::live == 1 && cache.size() == 1);
+    }
+
+    struct string_value
+    {
+        std::string key;
+
+        explicit string_value(const std::string& key)
+            : key(key) {}
+    };
+
+    void test_keys_spread_over_shards()
+    {
+        ft::weak_cache<long, value> cache(4);
+        ft::shared_ptr<value> held[64];
+        for (long k = 0; k < 64; k++)
+        {
+            held[k] = cache.get(k * 64);
+        }
+        CHECK(cache.size() == 64);
+        for (long k = 0; k < 64; k++)
+        {
+            CHECK(cache.find(k * 64) == held[k]);
+        }
+
+        ft::weak_cache<std::string, string_value> strings;
+        ft::shared_ptr<string_value> s = strings.get("key");
+        CHECK(strings.get("key") == s && s->key == "key");
+    }
+}
+
+int main()
+{
+    test_hit_returns_the_live_object();
+    test_last_release_evicts();
+    test_keys_spread_over_shards();
+    CHECK(value::live == 0);
+    std::printf("weak_cache: ok\n");
+    return 0;
+}
@@ -0,0 +1,344 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_compressed_pair.hpp"
+#include "_ptr_element.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace ft
+{
+    template <typename T>
+    struct default_delete
+    {
+        default_delete() throw() {}
+
+        template <typename U>
+        default_delete(const default_delete<U>&) throw()
+        {
+            _internal::assert_convertible<U, T>();
+        }
+
+        void operator()(T* p) const throw()
+        {
+            // Compile-time test
+            static_cast<void>(sizeof(char[sizeof(T) > 0 ? 1 : -1]));
+
+            delete p;
+        }
+    };
+
+    template <typename T>
+    struct default_delete<T[]>
+    {
+        default_delete() throw() {}
+
+        void operator()(T* p) const throw()
+        {
+            // Compile-time test
+            static_cast<void>(sizeof(char[sizeof(T) > 0 ? 1 : -1]));
+
+            delete[] p;
+        }
+    };
+
+    template <typename T, typename TDelete = default_delete<T> >
+    class unique_ptr;
+
+    namespace _internal
+    {
+        template <typename T, typename TDelete>
+        class unique_ptr_ref;
+    }
+
+    // sole ownership, the size of a raw pointer with an empty deleter.
+    // moves from temporaries; an lvalue is moved with ft::move.
+    // TDelete is a function object or function pointer type.
+    template <typename T, typename TDelete>
+    class unique_ptr
+    {
+    public:
+        typedef typename _internal::element_type<T>::type element_type;
+        typedef element_type* pointer;
+        typedef TDelete deleter_type;
+
+    private:
+        template <typename U, typename UDelete>
+        friend class unique_ptr;
+
+    private:
+        _internal::compressed_pair<pointer, TDelete> data;
+
+#if __cplusplus >= 201103L
+    public:
+        unique_ptr(const unique_ptr&) = delete;
+        unique_ptr& operator=(const unique_ptr&) = delete;
+#else
+    private:
+        unique_ptr(unique_ptr&);
+        unique_ptr& operator=(unique_ptr&);
+#endif
+
+    public:
+        unique_ptr() throw()
+            : data() {}
+
+        explicit unique_ptr(pointer p) throw()
+            : data(p) {}
+
+        unique_ptr(pointer p, const TDelete& del) throw()
+            : data(p, del) {}
+
+#if __cplusplus >= 201103L
+        unique_ptr(unique_ptr&& that) noexcept
+            : data(that.release(), that.get_deleter()) {}
+
+        template <typename U, typename UDelete>
+        unique_ptr(unique_ptr<U, UDelete>&& that) noexcept
+            : data(that.release(), that.get_deleter())
+        {
+            _internal::assert_convertible<U, T>();
+        }
+
+        unique_ptr& operator=(unique_ptr&& that) noexcept
+        {
+            this->reset(that.release());
+            this->get_deleter() = that.get_deleter();
+            return *this;
+        }
+
+        template <typename U, typename UDelete>
+        unique_ptr& operator=(unique_ptr<U, UDelete>&& that) noexcept
+        {
+            _internal::assert_convertible<U, T>();
+
+            this->reset(that.release());
+            this->get_deleter() = that.get_deleter();
+            return *this;
+        }
+#else
+        unique_ptr(_internal::unique_ptr_ref<T, TDelete>& that) throw()
+            : data(that.release(), that.get_deleter()) {}
+
+        // from a temporary or ft::move of another type
+        template <typename U, typename UDelete>
+        unique_ptr(unique_ptr<U, UDelete> that) throw()
+            : data(that.release(), that.get_deleter())
+        {
+            _internal::assert_convertible<U, T>();
+        }
+
+        unique_ptr& operator=(_internal::unique_ptr_ref<T, TDelete>& that) throw()
+        {
+            this->reset(that.release());
+            this->get_deleter() = that.get_deleter();
+            return *this;
+        }
+
+        operator _internal::unique_ptr_ref<T, TDelete>&() throw()
+        {
+            return static_cast<_internal::unique_ptr_ref<T, TDelete>&>(*this);
+        }
+#endif
+
+        ~unique_ptr() throw()
+        {
+            if (this->data.first() != NULL)
+            {
+                this->get_deleter()(this->data.first());
+            }
+        }
+
+        pointer release() throw()
+        {
+            pointer p = this->data.first();
+            this->data.first() = NULL;
+            return p;
+        }
+
+        void reset(pointer p = NULL) throw()
+        {
+            assert(p == NULL || p != this->data.first());
+
+            pointer old = this->data.first();
+            this->data.first() = p;
+            if (old != NULL)
+            {
+                this->get_deleter()(old);
+            }
+        }
+
+        typename _internal::dereference<T>::type operator*() const throw()
+        {
+            assert(this->data.first() != NULL);
+
+            return *this->data.first();
+        }
+
+        typename _internal::member_access<T>::type operator->() const throw()
+        {
+            assert(this->data.first() != NULL);
+
+            return this->data.first();
+        }
+
+        typename _internal::array_access<T>::type operator[](std::ptrdiff_t i) const throw()
+        {
+            assert(this->data.first() != NULL);
+
+            return this->data.first()[i];
+        }
+
+        pointer get() const throw()
+        {
+            return this->data.first();
+        }
+
+        TDelete& get_deleter() throw()
+        {
+            return this->data.second();
+        }
+
+        const TDelete& get_deleter() const throw()
+        {
+            return this->data.second();
+        }
+
+        // explicit operator bool
+        void unspecified_bool_type_func() const {}
+        typedef void (unique_ptr::*unspecified_bool_type)() const;
+        operator unspecified_bool_type() const throw()
+        {
+            return this->data.first() == NULL ? NULL : &unique_ptr::unspecified_bool_type_func;
+        }
+
+        void swap(unique_ptr& that) throw()
+        {
+            std::swap(this->data.first(), that.data.first());
+            std::swap(this->get_deleter(), that.get_deleter());
+        }
+    };
+
+    namespace _internal
+    {
+        // rvalue of unique_ptr for move emulation, never constructed.
+        // being derived from unique_ptr, copy initialization from it picks the constructors directly.
+        template <typename T, typename TDelete>
+        class unique_ptr_ref : public unique_ptr<T, TDelete>
+        {
+        private:
+            unique_ptr_ref();
+            unique_ptr_ref(const unique_ptr_ref&);
+            ~unique_ptr_ref();
+            unique_ptr_ref& operator=(const unique_ptr_ref&);
+        };
+    }
+
+#if __cplusplus >= 201103L
+    template <typename T, typename TDelete>
+    unique_ptr<T, TDelete>&& move(unique_ptr<T, TDelete>& that) throw()
+    {
+        return static_cast<unique_ptr<T, TDelete>&&>(that);
+    }
+#else
+    template <typename T, typename TDelete>
+    _internal::unique_ptr_ref<T, TDelete>& move(unique_ptr<T, TDelete>& that) throw()
+    {
+        return static_cast<_internal::unique_ptr_ref<T, TDelete>&>(that);
+    }
+#endif
+
+    template <typename T, typename TDelete, typename U, typename UDelete>
+    bool operator==(const unique_ptr<T, TDelete>& lhs, const unique_ptr<U, UDelete>& rhs) throw()
+    {
+        return lhs.get() == rhs.get();
+    }
+
+    template <typename T, typename TDelete, typename U, typename UDelete>
+    bool operator!=(const unique_ptr<T, TDelete>& lhs, const unique_ptr<U, UDelete>& rhs) throw()
+    {
+        return lhs.get() != rhs.get();
+    }
+
+    template <typename T, typename TDelete, typename U, typename UDelete>
+    bool operator<(const unique_ptr<T, TDelete>& lhs, const unique_ptr<U, UDelete>& rhs) throw()
+    {
+        return lhs.get() < rhs.get();
+    }
+
+    template <typename T, typename TDelete>
+    void swap(unique_ptr<T, TDelete>& lhs, unique_ptr<T, TDelete>& rhs) throw()
+    {
+        lhs.swap(rhs);
+    }
+
+    template <typename T>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique()
+    {
+        return unique_ptr<T>(::new T());
+    }
+
+    template <typename T, typename A1>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1)));
+    }
+
+    template <typename T, typename A1, typename A2>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4), const_cast<A5&>(a5)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4), const_cast<A5&>(a5), const_cast<A6&>(a6)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4), const_cast<A5&>(a5), const_cast<A6&>(a6), const_cast<A7&>(a7)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4), const_cast<A5&>(a5), const_cast<A6&>(a6), const_cast<A7&>(a7), const_cast<A8&>(a8)));
+    }
+
+    template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+    typename _internal::enable_if<!_internal::is_array<T>::value, unique_ptr<T> >::type make_unique(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
+    {
+        return unique_ptr<T>(::new T(const_cast<A1&>(a1), const_cast<A2&>(a2), const_cast<A3&>(a3), const_cast<A4&>(a4), const_cast<A5&>(a5), const_cast<A6&>(a6), const_cast<A7&>(a7), const_cast<A8&>(a8), const_cast<A9&>(a9)));
+    }
+
+    template <typename T>
+    typename _internal::enable_if<_internal::is_unbounded_array<T>::value, unique_ptr<T> >::type make_unique(std::size_t n)
+    {
+        return unique_ptr<T>(::new typename _internal::element_type<T>::type[n]());
+    }
+}
@@ -0,0 +1,227 @@
+/* Any copyright is dedicated to the Public Domain.
+ * https://creativecommons.org/publicdomain/zero/1.0/ */
+
+#pragma once
+
+#include "_exception.hpp"
+#include "_hash.hpp"
+#include "_mutex.hpp"
+#include "make_shared.hpp"
+#include "shared_ptr.hpp"
+#include "weak_ptr.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ft
+{
+    // interning cache: returns the live object for a key, or builds one if nobody holds it.
+    // entries are removed when the last reference handed out by the cache is released.
+    template <typename K, typename V, typename THash = _internal::hash<K>, typename TCompare = std::less<K> >
+    class weak_cache
+    {
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef ft::shared_ptr<V> value_type;
+
+    private:
+        struct entry
+        {
+            ft::weak_ptr<V> value;
+            bool pending;
+
+            entry() throw()
+                : value(), pending(false) {}
+        };
+
+        typedef std::map<K, entry, TCompare> map_type;
+
+        struct shard
+        {
+            _internal::mutex mutex;
+            _internal::condition ready;
+            map_type map;
+
+            explicit shard(const TCompare& comp)
+                : mutex(), ready(), map(comp) {}
+        };
+
+        // owns the object built by the factory, erases the entry once the last handle dies
+        struct evictor
+        {
+            ft::shared_ptr<shard> owner;
+            K key;
+            ft::shared_ptr<V> value;
+
+            evictor(const ft::shared_ptr<shard>& owner, const K& key, const ft::shared_ptr<V>& value)
+                : owner(owner), key(key), value(value) {}
+
+            void operator()(V*) throw()
+            {
+                {
+                    _internal::mutex_guard guard(this->owner->mutex);
+
+                    typename map_type::iterator it = this->owner->map.find(this->key);
+                    if (it != this->owner->map.end() && !it->second.pending && it->second.value.expired())
+                    {
+                        this->owner->map.erase(it);
+                    }
+                }
+                // destroy outside the shard lock
+                this->value.reset();
+            }
+        };
+
+        struct make_shared_factory
+        {
+            ft::shared_ptr<V> operator()(const K& key) const
+            {
+                return ft::make_shared<V>(key);
+            }
+        };
+
+    private:
+        std::vector<ft::shared_ptr<shard> > shards;
+        THash hasher;
+
+        weak_cache(const weak_cache&);
+        weak_cache& operator=(const weak_cache&);
+
+    public:
+        explicit weak_cache(std::size_t shard_count = 16, const THash& hasher = THash(), const TCompare& comp = TCompare())
+            : shards(), hasher(hasher)
+        {
+            assert(shard_count != 0);
+
+            this->shards.reserve(shard_count);
+            for (std::size_t i = 0; i < shard_count; i++)
+            {
+                this->shards.push_back(ft::make_shared<shard>(comp));
+            }
+        }
+
+        ~weak_cache() {}
+
+        // the live object for `key`, or an empty pointer
+        ft::shared_ptr<V> find(const K& key) const
+        {
+            shard& s = this->shard_of(key);
+            _internal::mutex_guard guard(s.mutex);
+
+            typename map_type::iterator it = s.map.find(key);
+            if (it == s.map.end() || it->second.pending)
+            {
+                return ft::shared_ptr<V>();
+            }
+            return it->second.value.lock();
+        }
+
+        // the live object for `key`, or a new one from make_shared<V>(key)
+        ft::shared_ptr<V> get(const K& key)
+        {
+            return this->get(key, make_shared_factory());
+        }
+
+        // the live object for `key`, or a new one from factory(key).
+        // concurrent misses on the same key wait for a single construction.
+        template <typename TFactory>
+        ft::shared_ptr<V> get(const K& key, TFactory factory)
+        {
+            const ft::shared_ptr<shard>& owner = this->shards[this->shard_index(key)];
+            shard& s = *owner;
+
+            s.mutex.lock();
+            for (;;)
+            {
+                typename map_type::iterator it = s.map.find(key);
+                if (it == s.map.end())
+                {
+                    break;
+                }
+                if (!it->second.pending)
+                {
+                    ft::shared_ptr<V> hit = it->second.value.lock();
+                    if (hit)
+                    {
+                        s.mutex.unlock();
+                        return hit;
+                    }
+                    // expired, its eviction is still on the way
+                    break;
+                }
+                s.ready.wait(s.mutex);
+            }
+
+            entry& pending = s.map[key];
+            pending.value.reset();
+            pending.pending = true;
+            s.mutex.unlock();
+
+            ft::shared_ptr<V> result;
+            SMART_PTR_TRY
+            {
+                ft::shared_ptr<V> value = factory(key);
+                if (value)
+                {
+                    result = ft::shared_ptr<V>(value.get(), evictor(owner, key, value));
+                }
+            }
+            SMART_PTR_CATCH_ALL
+            {
+                s.mutex.lock();
+                s.map.erase(key);
+                s.ready.broadcast();
+                s.mutex.unlock();
+                SMART_PTR_RETHROW;
+            }
+
+            s.mutex.lock();
+            if (result)
+            {
+                entry& built = s.map[key];
+                built.value = result;
+                built.pending = false;
+            }
+            else
+            {
+                s.map.erase(key);
+            }
+            s.ready.broadcast();
+            s.mutex.unlock();
+
+            return result;
+        }
+
+        std::size_t size() const
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < this->shards.size(); i++)
+            {
+                _internal::mutex_guard guard(this->shards[i]->mutex);
+                result += this->shards[i]->map.size();
+            }
+            return result;
+        }
+
+        bool empty() const
+        {
+            return this->size() == 0;
+        }
+
+    private:
+        // the hash is mixed first, identity hashes of pointers and integers share their low bits
+        std::size_t shard_index(const K& key) const
+        {
+            return _internal::mix_hash(this->hasher(key)) % this->shards.size();
+        }
+
+        shard& shard_of(const K& key) const
+        {
+            return *this->shards[this->shard_index(key)];
+        }
+    };
+}
@@ -3,12 +3,14 @@
 
 #pragma once
 
+#include "_hash.hpp"
 #include "_ptr_element.hpp"
 #include "_ref_counted.hpp"
 #include "shared_ptr.hpp"
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 
 namespace ft
 {
@@ -41,7 +43,7 @@ namespace ft
         }
 
         weak_ptr(const weak_ptr& that) throw()
-            : ptr(that.lock().get()), ref(that.ref) {}
+            : ptr(that.ptr), ref(that.ref) {}
 
         template <typename U>
         weak_ptr(const weak_ptr<U>& that) throw()
@@ -58,11 +60,27 @@ namespace ft
         weak_ptr(const weak_ptr<U>& that, element_type* p) throw()
             : ptr(p), ref(that.ref) {}
 
+        // Internal BEGIN
+        // adopts a weak reference already taken on `counted`
+        weak_ptr(_internal::adopt_tag, element_type* p, _internal::_counted_base* counted) throw()
+            : ptr(p), ref(counted) {}
+
+        _internal::_counted_base* get_counted() const throw()
+        {
+            return this->ref.get_counted();
+        }
+
+        element_type* get_internal() const throw()
+        {
+            return this->ptr;
+        }
+        // Internal END
+
         ~weak_ptr() throw() {}
 
         weak_ptr& operator=(const weak_ptr& that) throw()
         {
-            this->ptr = that.lock().get();
+            this->ptr = that.ptr;
             this->ref = that.ref;
             return *this;
         }
@@ -97,9 +115,38 @@ namespace ft
             return this->use_count() == 0;
         }
 
+        template <typename U>
+        bool owner_before(const shared_ptr<U>& that) const throw()
+        {
+            return std::less<_internal::_counted_base*>()(this->get_counted(), that.get_counted());
+        }
+
+        template <typename U>
+        bool owner_before(const weak_ptr<U>& that) const throw()
+        {
+            return std::less<_internal::_counted_base*>()(this->get_counted(), that.get_counted());
+        }
+
+        template <typename U>
+        bool owner_equal(const shared_ptr<U>& that) const throw()
+        {
+            return this->get_counted() == that.get_counted();
+        }
+
+        template <typename U>
+        bool owner_equal(const weak_ptr<U>& that) const throw()
+        {
+            return this->get_counted() == that.get_counted();
+        }
+
+        std::size_t owner_hash() const throw()
+        {
+            return _internal::mix_hash(reinterpret_cast<std::size_t>(this->get_counted()));
+        }
+
         shared_ptr<T> lock() const throw()
         {
-            return shared_ptr<T>(*this);
+            return shared_ptr<T>(*this, _internal::nothrow_tag());
         }
 
         void reset() throw()